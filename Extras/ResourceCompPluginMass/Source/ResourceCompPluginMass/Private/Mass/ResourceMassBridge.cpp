@@ -0,0 +1,52 @@
+// Copyright LyCH. 2024
+
+
+#include "Mass/ResourceMassBridge.h"
+#include "Components/Health/HealthResource.h"
+#include "MassEntityManager.h"
+#include "MassCommands.h"
+#include "Engine/World.h"
+
+namespace ResourceMass {
+	bool QueueDamage(FMassEntityManager& entityManager, FMassEntityHandle entity, const FResourceMassDamage& damage) {
+		check(IsInGameThread());
+		if (!entityManager.IsEntityValid(entity)) {
+			return false;
+		}
+		FResourceMassPendingDamageFragment* pendingDamage = entityManager.GetFragmentDataPtr<FResourceMassPendingDamageFragment>(entity);
+		if (!pendingDamage) {
+			return false;
+		}
+		pendingDamage->Pending.Add(damage);
+		return true;
+	}
+	void ApplyDamageOverTime(FMassEntityManager& entityManager, FMassEntityHandle entity, const FResourceMassDamage& damagePerTick, float tickInterval, int32 numTicks) {
+		check(IsInGameThread());
+		if (!entityManager.IsEntityValid(entity) || numTicks <= 0) {
+			return;
+		}
+		FResourceMassDamageOverTimeFragment dot;
+		dot.DamagePerTick = damagePerTick;
+		dot.TickInterval = tickInterval;
+		dot.RemainingTicks = numTicks;
+		dot.NextTickTime = entityManager.GetWorld()->GetTimeSeconds() + tickInterval;
+		if (FResourceMassDamageOverTimeFragment* existing = entityManager.GetFragmentDataPtr<FResourceMassDamageOverTimeFragment>(entity)) {
+			*existing = dot;
+		}
+		else {
+			entityManager.Defer().PushCommand<FMassCommandAddFragmentInstances>(entity, dot);
+		}
+	}
+	bool PromoteToHealthResource(const FMassEntityManager& entityManager, FMassEntityHandle entity, UHealthResource* health) {
+		check(IsInGameThread());
+		if (!IsValid(health) || !health->HasBegunPlay() || !entityManager.IsEntityValid(entity)) {
+			return false;
+		}
+		const FResourceMassFragment* resource = entityManager.GetFragmentDataPtr<FResourceMassFragment>(entity);
+		if (!resource) {
+			return false;
+		}
+		health->ImportState(resource->ToCoreState(health->GetEffectiveMaxAmount()));
+		return true;
+	}
+}
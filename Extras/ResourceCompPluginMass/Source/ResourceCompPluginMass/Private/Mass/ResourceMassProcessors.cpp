@@ -0,0 +1,135 @@
+// Copyright LyCH. 2024
+
+
+#include "Mass/ResourceMassProcessors.h"
+#include "Mass/ResourceMassFragments.h"
+#include "Core/ResourceCoreUtils.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "Engine/World.h"
+
+namespace {
+	/*
+	 * Same query UHealthResource::ModifyDamage builds. Entities have no actor, so damage type interfaces receive none.
+	 */
+	uint32 ApplyHit(ResourceCore::FResourceState& state, const FResourceMassConfigFragment& config, const FResourceMassDamage& hit, double now, const ResourceCore::FDamageTypeOps& ops) {
+		float damage = hit.Damage;
+		const std::vector<ResourceCore::FModificationRule>* rules = config.GetRules();
+		if (rules && !rules->empty()) {
+			ResourceCore::FDamageQuery query;
+			query.Damage = hit.Damage;
+			query.Channel = ResourceCore::ToCoreChannel(hit.Channel);
+			query.DamageType = ResourceCore::MakeTypeId(hit.DamageType.Get());
+			query.Bone = ResourceCore::MakeNameId(hit.BoneName);
+			query.Distance = hit.Distance;
+			damage = ResourceCore::ModifyDamage(*rules, query, ops);
+		}
+		return ResourceCore::Drain(state, damage, now, config.GetRegenParams());
+	}
+}
+
+UResourceMassDamageProcessor::UResourceMassDamageProcessor()
+	: PendingDamageQuery(*this), DamageOverTimeQuery(*this) {
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	bRequiresGameThreadExecution = true;
+}
+void UResourceMassDamageProcessor::ConfigureQueries() {
+	PendingDamageQuery.AddRequirement<FResourceMassFragment>(EMassFragmentAccess::ReadWrite);
+	PendingDamageQuery.AddRequirement<FResourceMassPendingDamageFragment>(EMassFragmentAccess::ReadWrite);
+	PendingDamageQuery.AddConstSharedRequirement<FResourceMassConfigFragment>();
+
+	DamageOverTimeQuery.AddRequirement<FResourceMassFragment>(EMassFragmentAccess::ReadWrite);
+	DamageOverTimeQuery.AddRequirement<FResourceMassDamageOverTimeFragment>(EMassFragmentAccess::ReadWrite);
+	DamageOverTimeQuery.AddConstSharedRequirement<FResourceMassConfigFragment>();
+}
+void UResourceMassDamageProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) {
+	const double now = Context.GetWorld()->GetTimeSeconds();
+	const ResourceCore::FDamageTypeOps ops = ResourceCore::MakeDamageTypeOps(nullptr);
+
+	PendingDamageQuery.ForEachEntityChunk(EntityManager, Context, [now, &ops](FMassExecutionContext& context) {
+		const FResourceMassConfigFragment& config = context.GetConstSharedFragment<FResourceMassConfigFragment>();
+		const TArrayView<FResourceMassFragment> resources = context.GetMutableFragmentView<FResourceMassFragment>();
+		const TArrayView<FResourceMassPendingDamageFragment> pendingDamage = context.GetMutableFragmentView<FResourceMassPendingDamageFragment>();
+		for (int32 i = 0; i < context.GetNumEntities(); i++) {
+			TArray<FResourceMassDamage>& pending = pendingDamage[i].Pending;
+			if (pending.IsEmpty()) {
+				continue;
+			}
+			ResourceCore::FResourceState state = resources[i].ToCoreState(config.MaxAmount);
+			uint32 events = ResourceCore::Event_None;
+			for (const FResourceMassDamage& hit : pending) {
+				events |= ApplyHit(state, config, hit, now, ops);
+			}
+			resources[i].FromCoreState(state);
+			pending.Reset();
+			if ((events & ResourceCore::Event_Emptied) && state.Current <= 0) {
+				context.Defer().AddTag<FResourceMassDepletedTag>(context.GetEntity(i));
+			}
+		}
+	});
+
+	DamageOverTimeQuery.ForEachEntityChunk(EntityManager, Context, [now, &ops](FMassExecutionContext& context) {
+		const FResourceMassConfigFragment& config = context.GetConstSharedFragment<FResourceMassConfigFragment>();
+		const TArrayView<FResourceMassFragment> resources = context.GetMutableFragmentView<FResourceMassFragment>();
+		const TArrayView<FResourceMassDamageOverTimeFragment> damageOverTime = context.GetMutableFragmentView<FResourceMassDamageOverTimeFragment>();
+		for (int32 i = 0; i < context.GetNumEntities(); i++) {
+			FResourceMassDamageOverTimeFragment& dot = damageOverTime[i];
+			if (dot.RemainingTicks > 0 && dot.NextTickTime <= now) {
+				ResourceCore::FResourceState state = resources[i].ToCoreState(config.MaxAmount);
+				uint32 events = ResourceCore::Event_None;
+				// Catch up on every tick missed since the last frame, each as its own hit.
+				while (dot.RemainingTicks > 0 && dot.NextTickTime <= now) {
+					events |= ApplyHit(state, config, dot.DamagePerTick, now, ops);
+					dot.NextTickTime += FMath::Max(dot.TickInterval, UE_KINDA_SMALL_NUMBER);
+					dot.RemainingTicks--;
+				}
+				resources[i].FromCoreState(state);
+				if ((events & ResourceCore::Event_Emptied) && state.Current <= 0) {
+					context.Defer().AddTag<FResourceMassDepletedTag>(context.GetEntity(i));
+				}
+			}
+			if (dot.RemainingTicks <= 0) {
+				context.Defer().RemoveFragment<FResourceMassDamageOverTimeFragment>(context.GetEntity(i));
+			}
+		}
+	});
+}
+
+UResourceMassRegenProcessor::UResourceMassRegenProcessor()
+	: EntityQuery(*this) {
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ExecutionOrder.ExecuteAfter.Add(UResourceMassDamageProcessor::StaticClass()->GetFName());
+}
+void UResourceMassRegenProcessor::ConfigureQueries() {
+	EntityQuery.AddRequirement<FResourceMassFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FResourceMassConfigFragment>();
+}
+void UResourceMassRegenProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) {
+	const double now = Context.GetWorld()->GetTimeSeconds();
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [now](FMassExecutionContext& context) {
+		const FResourceMassConfigFragment& config = context.GetConstSharedFragment<FResourceMassConfigFragment>();
+		const ResourceCore::FRegenParams params = config.GetRegenParams();
+		const bool bDepletedChunk = context.DoesArchetypeHaveTag<FResourceMassDepletedTag>();
+		const TArrayView<FResourceMassFragment> resources = context.GetMutableFragmentView<FResourceMassFragment>();
+		for (int32 i = 0; i < context.GetNumEntities(); i++) {
+			FResourceMassFragment& resource = resources[i];
+			if (resource.NextRegenTime < 0) {
+				// Regen is unscheduled while full, and for entities spawned below their max until their first frame.
+				if (resource.CurrentAmount < config.MaxAmount && ResourceCore::ShouldRegen(resource.CurrentAmount, params)) {
+					ResourceCore::FResourceState state = resource.ToCoreState(config.MaxAmount);
+					ResourceCore::RestartRegen(state, now, params);
+					resource.FromCoreState(state);
+				}
+			}
+			else if (resource.NextRegenTime <= now) {
+				ResourceCore::FResourceState state = resource.ToCoreState(config.MaxAmount);
+				ResourceCore::AdvanceRegen(state, now, params);
+				resource.FromCoreState(state);
+			}
+			if (bDepletedChunk && resource.CurrentAmount > 0) {
+				context.Defer().RemoveTag<FResourceMassDepletedTag>(context.GetEntity(i));
+			}
+		}
+	});
+}
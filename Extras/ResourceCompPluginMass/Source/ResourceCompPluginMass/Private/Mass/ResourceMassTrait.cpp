@@ -0,0 +1,35 @@
+// Copyright LyCH. 2024
+
+
+#include "Mass/ResourceMassTrait.h"
+#include "Mass/ResourceMassFragments.h"
+#include "Data/ResourceArchetypeData.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+
+void UResourceMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const {
+	FResourceMassConfigFragment config;
+	bool bRegenBeginsEmpty = false;
+	if (IsValid(Archetype)) {
+		// Builds the compiled rules on the game thread, before any processor reads them.
+		Archetype->GetSharedRules();
+		config.Archetype = Archetype;
+		config.MaxAmount = Archetype->MaxAmount;
+		config.RegenAmount = Archetype->RegenAmount;
+		config.RegenRate = Archetype->RegenRate;
+		config.RegenDelay = Archetype->RegenDelay;
+		config.AdditionalExhaustedDelay = Archetype->AdditionalExhaustedDelay;
+		config.bRegenAfterDepletion = Archetype->bRegenAfterDepletion;
+		bRegenBeginsEmpty = Archetype->bRegenBeginsEmpty;
+	}
+
+	FResourceMassFragment& resource = BuildContext.AddFragment_GetRef<FResourceMassFragment>();
+	// Regen for entities that begin empty is scheduled by UResourceMassRegenProcessor on their first frame.
+	resource.CurrentAmount = bRegenBeginsEmpty ? 0.f : config.MaxAmount;
+	if (bCanTakeDamage) {
+		BuildContext.AddFragment<FResourceMassPendingDamageFragment>();
+	}
+
+	FMassEntityManager& entityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+	BuildContext.AddConstSharedFragment(entityManager.GetOrCreateConstSharedFragment(config));
+}
@@ -0,0 +1,5 @@
+// Copyright LyCH. 2024
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, ResourceCompPluginMass)
@@ -0,0 +1,30 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityHandle.h"
+#include "Mass/ResourceMassFragments.h"
+
+struct FMassEntityManager;
+class UHealthResource;
+
+/**
+ * Game thread entry points for resources on Mass entities, and the handoff to actor components.
+ */
+namespace ResourceMass {
+	/*
+	 * Queues a hit for UResourceMassDamageProcessor. Returns false if the entity cannot take damage.
+	 */
+	RESOURCECOMPPLUGINMASS_API bool QueueDamage(FMassEntityManager& entityManager, FMassEntityHandle entity, const FResourceMassDamage& damage);
+	/*
+	 * Starts damage over time with its first tick one interval from now, replacing any running one.
+	 */
+	RESOURCECOMPPLUGINMASS_API void ApplyDamageOverTime(FMassEntityManager& entityManager, FMassEntityHandle entity, const FResourceMassDamage& damagePerTick, float tickInterval, int32 numTicks);
+	/*
+	 * Moves the entity's amount, drain time and regen schedule into the health resource of the actor it was promoted to.
+	 * Call after the actor's BeginPlay, on the server. The health resource should use the entity's archetype so both
+	 * apply the same rules. Damage over time stays with the entity.
+	 */
+	RESOURCECOMPPLUGINMASS_API bool PromoteToHealthResource(const FMassEntityManager& entityManager, FMassEntityHandle entity, UHealthResource* health);
+}
@@ -0,0 +1,139 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Core/ResourceCore.h"
+#include "Data/DamageModificationData.h"
+#include "Data/ResourceArchetypeData.h"
+#include "ResourceMassFragments.generated.h"
+
+class UDamageType;
+
+/*
+ * The mutable part of a resource on a Mass entity. Mirrors ResourceCore::FResourceState, with times in world seconds.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassFragment : public FMassFragment {
+	GENERATED_BODY()
+	UPROPERTY()
+	float CurrentAmount = 100.f;
+	UPROPERTY()
+	double TimeAtLastDrain = 0.0;
+	// Negative while regen is not scheduled.
+	UPROPERTY()
+	double NextRegenTime = -1.0;
+	UPROPERTY()
+	bool bDrainDisabled = false;
+	UPROPERTY()
+	bool bFirstRegenTick = false;
+
+	ResourceCore::FResourceState ToCoreState(float maxAmount) const {
+		ResourceCore::FResourceState state;
+		state.Current = CurrentAmount;
+		state.Max = maxAmount;
+		state.TimeAtLastDrain = TimeAtLastDrain;
+		state.NextRegenTime = NextRegenTime;
+		state.bDrainDisabled = bDrainDisabled;
+		state.bFirstRegenTick = bFirstRegenTick;
+		return state;
+	}
+	void FromCoreState(const ResourceCore::FResourceState& state) {
+		CurrentAmount = state.Current;
+		TimeAtLastDrain = state.TimeAtLastDrain;
+		NextRegenTime = state.NextRegenTime;
+		bDrainDisabled = state.bDrainDisabled;
+		bFirstRegenTick = state.bFirstRegenTick;
+	}
+};
+
+/*
+ * Configuration shared by every entity built from the same archetype. Damage rules are read from the archetype's
+ * compiled rules, so entities use the same rule semantics as a UHealthResource with that archetype.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassConfigFragment : public FMassConstSharedFragment {
+	GENERATED_BODY()
+	UPROPERTY()
+	TObjectPtr<UResourceArchetypeData> Archetype;
+	UPROPERTY()
+	float MaxAmount = 100.f;
+	UPROPERTY()
+	float RegenAmount = 5.f;
+	UPROPERTY()
+	float RegenRate = 5.f;
+	UPROPERTY()
+	float RegenDelay = 1.f;
+	UPROPERTY()
+	float AdditionalExhaustedDelay = 0.f;
+	UPROPERTY()
+	bool bRegenAfterDepletion = false;
+
+	ResourceCore::FRegenParams GetRegenParams() const {
+		ResourceCore::FRegenParams params;
+		params.Amount = RegenAmount;
+		params.Rate = RegenRate;
+		params.Delay = RegenDelay;
+		params.AdditionalExhaustedDelay = AdditionalExhaustedDelay;
+		params.bRegenAfterDepletion = bRegenAfterDepletion;
+		return params;
+	}
+	const std::vector<ResourceCore::FModificationRule>* GetRules() const {
+		return Archetype ? &Archetype->GetCompiledRules() : nullptr;
+	}
+};
+
+/*
+ * One hit, equivalent to the arguments of UHealthResource::ModifyDamage.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassDamage {
+	GENERATED_BODY()
+	UPROPERTY()
+	float Damage = 0.f;
+	UPROPERTY()
+	EIncomingDamageChannel Channel = EIncomingDamageChannel::GenericDamage;
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageType;
+	UPROPERTY()
+	FName BoneName;
+	// Distance between the damage origin and the entity.
+	UPROPERTY()
+	float Distance = 0.f;
+};
+
+/*
+ * Hits waiting for UResourceMassDamageProcessor. Fill it with ResourceMass::QueueDamage.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassPendingDamageFragment : public FMassFragment {
+	GENERATED_BODY()
+	UPROPERTY()
+	TArray<FResourceMassDamage> Pending;
+};
+
+/*
+ * Damage applied as a separate hit every TickInterval seconds, so rules see each tick the way they would see
+ * repeated ApplyDamage calls. Removed once RemainingTicks reaches 0.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassDamageOverTimeFragment : public FMassFragment {
+	GENERATED_BODY()
+	UPROPERTY()
+	FResourceMassDamage DamagePerTick;
+	UPROPERTY()
+	float TickInterval = 1.f;
+	UPROPERTY()
+	int32 RemainingTicks = 0;
+	UPROPERTY()
+	double NextTickTime = 0.0;
+};
+
+/*
+ * Present while the resource is at 0.
+ */
+USTRUCT()
+struct RESOURCECOMPPLUGINMASS_API FResourceMassDepletedTag : public FMassTag {
+	GENERATED_BODY()
+};
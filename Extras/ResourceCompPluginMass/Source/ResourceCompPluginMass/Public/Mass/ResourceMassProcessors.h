@@ -0,0 +1,46 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "ResourceMassProcessors.generated.h"
+
+/**
+ * Applies queued hits and due damage-over-time ticks through the archetype's modification rules, then drains.
+ * Runs on the game thread because Modify From Damage Type rules call into IDamageTypeModificationInterface.
+ */
+UCLASS()
+class RESOURCECOMPPLUGINMASS_API UResourceMassDamageProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+public:
+	UResourceMassDamageProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery PendingDamageQuery;
+	FMassEntityQuery DamageOverTimeQuery;
+};
+
+/**
+ * Applies every regen tick due this frame in constant time per entity, like the world store does for components.
+ */
+UCLASS()
+class RESOURCECOMPPLUGINMASS_API UResourceMassRegenProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+public:
+	UResourceMassRegenProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,31 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "ResourceMassTrait.generated.h"
+
+class UResourceArchetypeData;
+
+/**
+ * Gives Mass entities a resource configured by an archetype, with regen and damage processing.
+ * Entities built from the same archetype share one config fragment, including the compiled damage rules.
+ */
+UCLASS(meta = (DisplayName = "Resource"))
+class RESOURCECOMPPLUGINMASS_API UResourceMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+protected:
+	/*
+	 * Scalar values and damage rules. Without one, the entity uses the resource defaults and no rules.
+	 */UPROPERTY(EditAnywhere, Category = "Resource")
+	TObjectPtr<UResourceArchetypeData> Archetype;
+	/*
+	 * Adds the fragment queued hits need up front, so hitting an entity does not move it to another Mass archetype.
+	 * Damage over time adds its own fragment when applied.
+	 */UPROPERTY(EditAnywhere, Category = "Resource")
+	bool bCanTakeDamage = true;
+
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+};
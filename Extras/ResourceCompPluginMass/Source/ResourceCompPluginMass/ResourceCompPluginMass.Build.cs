@@ -0,0 +1,32 @@
+// Copyright LyCH. 2024
+
+using UnrealBuildTool;
+
+public class ResourceCompPluginMass : ModuleRules
+{
+	public ResourceCompPluginMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"Engine",
+				"MassEntity",
+				"MassSpawner",
+				"ResourceCompPlugin",
+			}
+			);
+			
+		
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"MassCommon",
+			}
+			);
+	}
+}
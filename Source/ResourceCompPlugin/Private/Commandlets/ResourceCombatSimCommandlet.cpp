@@ -0,0 +1,220 @@
+// Copyright LyCH. 2024
+
+
+#include "Commandlets/ResourceCombatSimCommandlet.h"
+#include "Core/ResourceCoreUtils.h"
+#include "Data/DamageModificationData.h"
+#include "Interfaces/DamageTypeModificationInterface.h"
+#include "ResourceCompPlugin.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "UObject/SoftObjectPath.h"
+
+//MP Reqs
+#include "GameFramework/DamageType.h"
+
+namespace ResourceCombatSim {
+	struct FConfig {
+		ResourceCore::FRegenParams Regen;
+		ResourceCore::FDamageQuery BaseQuery;
+		ResourceCore::FNameId Bone = 0;
+		float MaxAmount = 100.f;
+		float Damage = 10.f;
+		float HitsPerSecond = 2.f;
+		float Variance = 0.f;
+		float Accuracy = 1.f;
+		float BoneChance = 0.f;
+		float TimeStep = 0.05f;
+		float MaxTime = 120.f;
+	};
+
+	/*
+	 * Runs one engagement. Returns the time to kill, or a negative value if the target survived MaxTime.
+	 */
+	float RunEngagement(const FConfig& config, const std::vector<ResourceCore::FModificationRule>& rules, const ResourceCore::FDamageTypeOps& ops, FRandomStream& random) {
+		ResourceCore::FResourceState state;
+		state.Max = config.MaxAmount;
+		state.Current = config.MaxAmount;
+
+		const double hitInterval = 1.0 / config.HitsPerSecond;
+		// Random phase so hits do not always line up with the time step or regen ticks.
+		double nextHit = random.FRand() * hitInterval;
+		const int64 numSteps = FMath::CeilToInt64(config.MaxTime / config.TimeStep);
+		for (int64 step = 0; step <= numSteps; step++) {
+			const double now = step * static_cast<double>(config.TimeStep);
+			ResourceCore::AdvanceRegen(state, now, config.Regen);
+			while (nextHit <= now) {
+				nextHit += hitInterval;
+				if (random.FRand() >= config.Accuracy) {
+					continue;
+				}
+				ResourceCore::FDamageQuery query = config.BaseQuery;
+				query.Damage = config.Damage * (1.f + random.FRandRange(-config.Variance, config.Variance));
+				if (config.BoneChance > 0 && random.FRand() < config.BoneChance) {
+					query.Bone = config.Bone;
+				}
+				ResourceCore::Drain(state, ResourceCore::ModifyDamage(rules, query, ops), now, config.Regen);
+				if (state.Current <= 0) {
+					return static_cast<float>(now);
+				}
+			}
+		}
+		return -1.f;
+	}
+
+	UDamageModificationData* LoadModificationData(FString path) {
+		if (!path.Contains(TEXT("."))) {
+			path = FString::Printf(TEXT("%s.%s"), *path, *FPackageName::GetShortName(path));
+		}
+		return Cast<UDamageModificationData>(FSoftObjectPath(path).TryLoad());
+	}
+}
+
+UResourceCombatSimCommandlet::UResourceCombatSimCommandlet() {
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UResourceCombatSimCommandlet::Main(const FString& Params) {
+	using namespace ResourceCombatSim;
+	const TCHAR* params = *Params;
+
+	FConfig config;
+	FParse::Value(params, TEXT("MaxAmount="), config.MaxAmount);
+	FParse::Value(params, TEXT("RegenAmount="), config.Regen.Amount);
+	FParse::Value(params, TEXT("RegenRate="), config.Regen.Rate);
+	FParse::Value(params, TEXT("RegenDelay="), config.Regen.Delay);
+	FParse::Value(params, TEXT("AdditionalExhaustedDelay="), config.Regen.AdditionalExhaustedDelay);
+	config.Regen.bRegenAfterDepletion = FParse::Param(params, TEXT("RegenAfterDepletion"));
+	FParse::Value(params, TEXT("Damage="), config.Damage);
+	FParse::Value(params, TEXT("HitsPerSecond="), config.HitsPerSecond);
+	FParse::Value(params, TEXT("Variance="), config.Variance);
+	FParse::Value(params, TEXT("Accuracy="), config.Accuracy);
+	FParse::Value(params, TEXT("BoneChance="), config.BoneChance);
+	FParse::Value(params, TEXT("Distance="), config.BaseQuery.Distance);
+	FParse::Value(params, TEXT("TimeStep="), config.TimeStep);
+	FParse::Value(params, TEXT("MaxTime="), config.MaxTime);
+
+	int32 engagements = 1000000;
+	int32 seed = 1;
+	float bucketSize = 0.25f;
+	FString outputPath;
+	FParse::Value(params, TEXT("Engagements="), engagements);
+	FParse::Value(params, TEXT("Seed="), seed);
+	FParse::Value(params, TEXT("BucketSize="), bucketSize);
+	FParse::Value(params, TEXT("Output="), outputPath);
+
+	if (engagements <= 0 || config.HitsPerSecond <= 0 || config.TimeStep <= 0 || config.MaxTime <= 0 || bucketSize <= 0) {
+		UE_LOG(LogResourceComp, Error, TEXT("ResourceCombatSim: Engagements, HitsPerSecond, TimeStep, MaxTime and BucketSize must be positive."));
+		return 1;
+	}
+
+	/* Attacker channel, bone and damage type */ {
+		FString channel = TEXT("Point");
+		FParse::Value(params, TEXT("Channel="), channel);
+		config.BaseQuery.Channel = channel == TEXT("Radial") ? ResourceCore::EDamageChannel::Radial
+			: channel == TEXT("Generic") ? ResourceCore::EDamageChannel::Generic
+			: ResourceCore::EDamageChannel::Point;
+
+		FString bone;
+		if (FParse::Value(params, TEXT("Bone="), bone)) {
+			config.Bone = ResourceCore::MakeNameId(FName(*bone));
+		}
+		config.BaseQuery.Bone = ResourceCore::MakeNameId(NAME_None);
+	}
+	FString damageTypePath = TEXT("/Script/Engine.DamageType");
+	FParse::Value(params, TEXT("DamageType="), damageTypePath);
+	UClass* damageType = StaticLoadClass(UDamageType::StaticClass(), nullptr, *damageTypePath);
+	if (!damageType) {
+		UE_LOG(LogResourceComp, Error, TEXT("ResourceCombatSim: Could not load damage type %s."), *damageTypePath);
+		return 1;
+	}
+	config.BaseQuery.DamageType = ResourceCore::MakeTypeId(damageType);
+
+	/* Modification data, in the order given, the same way GiveModificationData appends it. */
+	TArray<FIncomingDamageModification> modifications;
+	FString modificationPaths;
+	if (FParse::Value(params, TEXT("Modifications="), modificationPaths, false)) {
+		TArray<FString> paths;
+		modificationPaths.ParseIntoArray(paths, TEXT(","));
+		for (const FString& path : paths) {
+			UDamageModificationData* data = LoadModificationData(path.TrimStartAndEnd());
+			if (!IsValid(data)) {
+				UE_LOG(LogResourceComp, Error, TEXT("ResourceCombatSim: Could not load modification data %s."), *path);
+				return 1;
+			}
+			modifications.Append(data->Modifications);
+		}
+	}
+	std::vector<ResourceCore::FModificationRule> rules;
+	ResourceCore::MakeRules(modifications, rules);
+	const ResourceCore::FDamageTypeOps ops = ResourceCore::MakeDamageTypeOps(nullptr);
+
+	// Damage types that modify damage themselves may run Blueprint, which can only happen on this thread.
+	const bool bUsesDamageTypeInterface = damageType->ImplementsInterface(UDamageTypeModificationInterface::StaticClass())
+		&& modifications.ContainsByPredicate([](const FIncomingDamageModification& m) { return m.ModificationType == EIncomingDamageModificationType::Modify_From_DamageType; });
+	if (bUsesDamageTypeInterface) {
+		UE_LOG(LogResourceComp, Warning, TEXT("ResourceCombatSim: %s modifies damage through the interface. Running single threaded."), *damageType->GetName());
+	}
+
+	/* Simulate. Chunks are seeded by index so results do not depend on the thread count. */
+	TArray<float> timesToKill;
+	timesToKill.SetNumUninitialized(engagements);
+	constexpr int32 chunkSize = 4096;
+	const int32 numChunks = FMath::DivideAndRoundUp(engagements, chunkSize);
+	const double start = FPlatformTime::Seconds();
+	ParallelFor(numChunks, [&](int32 chunk) {
+		FRandomStream random(seed + chunk);
+		const int32 first = chunk * chunkSize;
+		const int32 last = FMath::Min(first + chunkSize, engagements);
+		for (int32 i = first; i < last; i++) {
+			timesToKill[i] = RunEngagement(config, rules, ops, random);
+		}
+	}, bUsesDamageTypeInterface ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	const double elapsed = FPlatformTime::Seconds() - start;
+
+	/* Report */
+	timesToKill.Sort();
+	const int32 firstKill = Algo::LowerBound(timesToKill, 0.f);
+	const int32 kills = engagements - firstKill;
+	UE_LOG(LogResourceComp, Display, TEXT("ResourceCombatSim: %d engagements in %.2fs (%.0f simulated seconds per real second)."),
+		engagements, elapsed, engagements * static_cast<double>(config.MaxTime) / FMath::Max(elapsed, UE_SMALL_NUMBER));
+	UE_LOG(LogResourceComp, Display, TEXT("ResourceCombatSim: %d killed, %d survived %.1fs."), kills, firstKill, config.MaxTime);
+	if (kills > 0) {
+		auto percentile = [&](float p) { return timesToKill[firstKill + FMath::Min(kills - 1, FMath::FloorToInt(p * kills))]; };
+		double sum = 0.0;
+		for (int32 i = firstKill; i < engagements; i++) {
+			sum += timesToKill[i];
+		}
+		UE_LOG(LogResourceComp, Display, TEXT("ResourceCombatSim: TTK mean %.3fs, p5 %.3fs, p50 %.3fs, p95 %.3fs, max %.3fs."),
+			sum / kills, percentile(0.05f), percentile(0.5f), percentile(0.95f), timesToKill.Last());
+	}
+
+	if (!outputPath.IsEmpty()) {
+		const int32 numBuckets = FMath::CeilToInt(config.MaxTime / bucketSize) + 1;
+		TArray<int32> histogram;
+		histogram.SetNumZeroed(numBuckets);
+		for (int32 i = firstKill; i < engagements; i++) {
+			histogram[FMath::Min(numBuckets - 1, FMath::FloorToInt(timesToKill[i] / bucketSize))]++;
+		}
+		FString csv = TEXT("TimeToKill,Count,Cumulative\n");
+		int32 cumulative = 0;
+		for (int32 b = 0; b < numBuckets; b++) {
+			cumulative += histogram[b];
+			csv += FString::Printf(TEXT("%.3f,%d,%d\n"), b * bucketSize, histogram[b], cumulative);
+		}
+		csv += FString::Printf(TEXT("Survived,%d,%d\n"), firstKill, engagements);
+		if (!FFileHelper::SaveStringToFile(csv, *outputPath)) {
+			UE_LOG(LogResourceComp, Error, TEXT("ResourceCombatSim: Could not write %s."), *outputPath);
+			return 1;
+		}
+	}
+	return 0;
+}
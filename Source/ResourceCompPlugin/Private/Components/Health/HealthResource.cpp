@@ -4,6 +4,10 @@
 #include "Components/Health/HealthResource.h"
 #include "Interfaces/DamageTypeModificationInterface.h"
 #include "Data/DamageModificationData.h"
+#include "Data/ResourceArchetypeData.h"
+#include "Debug/ResourceNetStats.h"
+#include "Subsystems/ResourceAssetPreloader.h"
+#include "Core/ResourceCoreUtils.h"
 
 #include "Net/UnrealNetwork.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -17,6 +21,15 @@
 UHealthResource::UHealthResource() {
 	ResourceName = "Health";
 }
+void UHealthResource::OnRegister() {
+	Super::OnRegister();
+	// Starts loading the default data while the level streams in, so BeginPlay rarely waits for it.
+	if (!DefaultModificationData.IsNull() && GetWorld() && GetWorld()->IsGameWorld() && GetNetMode() != NM_Client) {
+		if (UResourceAssetPreloader* preloader = UResourceAssetPreloader::Get(this)) {
+			preloader->Request(DefaultModificationData.ToSoftObjectPath());
+		}
+	}
+}
 void UHealthResource::BeginPlay() {
 	Super::BeginPlay();
 	//Self delegates
@@ -24,16 +37,49 @@ void UHealthResource::BeginPlay() {
 		OnGenericDamageTaken.AddDynamic(this, &UHealthResource::GenericDamageTaken);
 		OnPointDamageTaken.AddDynamic(this, &UHealthResource::PointDamageTaken);
 		OnRadialDamageTaken.AddDynamic(this, &UHealthResource::RadialDamageTaken);
-		GiveModificationData(DefaultModificationData);
+		// Resolved before any damage, so the default rules always apply.
+		UDamageModificationData* defaultData = nullptr;
+		if (!DefaultModificationData.IsNull()) {
+			if (UResourceAssetPreloader* preloader = UResourceAssetPreloader::Get(this)) {
+				defaultData = preloader->Resolve(DefaultModificationData);
+			}
+		}
+		// Share the archetype's rules, with the default data merged in, unless this instance was given its own.
+		bUsesArchetypeRules = IsValid(Archetype) && ModificationRules.Num() == 0 && Archetype->GetSharedRules(defaultData).Rules.Num() > 0;
+		if (bUsesArchetypeRules) {
+			ArchetypeRulesData = defaultData;
+			if (IsValid(defaultData)) {
+				SendModificationDataAdded(defaultData);
+			}
+		}
+		else {
+			GiveModificationData(defaultData);
+		}
 	}
 	//Owner Delegates
 	BindDamageDelegates();
 }
 void UHealthResource::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(UHealthResource, ModificationRules);
-	DOREPLIFETIME(UHealthResource, LastDamageCauser);
-	DOREPLIFETIME(UHealthResource, LastLocationHitFrom);
+	// Conditions are set per component by ApplyReplicationPolicy.
+	FDoRepLifetimeParams params;
+	params.Condition = COND_Dynamic;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthResource, ModificationRules, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthResource, LastDamageCauser, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthResource, LastLocationHitFrom, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthResource, bUsesArchetypeRules, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthResource, ArchetypeRulesData, params);
+}
+void UHealthResource::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) {
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	SIZE_T bytes = ModificationRules.GetAllocatedSize() + CompiledRules.capacity() * sizeof(ResourceCore::FModificationRule);
+	for (const FIncomingDamageModification& rule : ModificationRules) {
+		bytes += rule.WhitelistedBoneNames.GetAllocatedSize() + rule.WhitelistedDamageTypes.GetAllocatedSize();
+	}
+	for (const ResourceCore::FModificationRule& rule : CompiledRules) {
+		bytes += rule.Bones.capacity() * sizeof(ResourceCore::FNameId) + rule.DamageTypes.capacity() * sizeof(ResourceCore::FTypeId);
+	}
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(bytes);
 }
 // Getters
 bool UHealthResource::IsServer() const {
@@ -52,7 +98,7 @@ bool UHealthResource::IsPlayerControlled() const {
 	return false;
 }
 bool UHealthResource::HasModifications(TArray<FName> modificationNames) {
-	for (FIncomingDamageModification m : ModificationRules) {
+	for (const FIncomingDamageModification& m : GetActiveRules()) {
 		if (modificationNames.Contains(m.ModificationName)) {
 			return true;
 		}
@@ -110,59 +156,112 @@ float UHealthResource::GetDirectionToLocation(const FVector& Location, const FRo
 float UHealthResource::K2_ModifyDamage_Implementation(float damageReceived, EIncomingDamageChannel damageChannel, const class UDamageType* DamageType, FName boneName, FVector damageOrigin) const {
 	return ModifyDamage(damageReceived, damageChannel, DamageType, boneName, damageOrigin);
 }
+bool UHealthResource::CanModifyDamageOffGameThread() const {
+	return IsNearestNativeClass(UHealthResource::StaticClass());
+}
+bool UHealthResource::IsNearestNativeClass(const UClass* nativeClass) const {
+	const UClass* currentClass = GetClass();
+	while (currentClass && !currentClass->HasAnyClassFlags(CLASS_Native)) {
+		currentClass = currentClass->GetSuperClass();
+	}
+	return currentClass == nativeClass;
+}
 float UHealthResource::ModifyDamage(float damageReceived, EIncomingDamageChannel damageChannel, const class UDamageType* DamageType, FName boneName, FVector damageOrigin) const {
-	float modifiedDamage = damageReceived;
-	bool bWhiteListedDamageType = true;
-	bool bCorrectBone = false;
-	bool bWithinRange = false;
-	bool bCorrectDamageChannel = false;
-	for (FIncomingDamageModification modification : ModificationRules) {
-		bWhiteListedDamageType = ModificationAcceptsDamageType(modification, DamageType);
-		bCorrectBone = (damageChannel != EIncomingDamageChannel::PointDamage || modification.WhitelistedBoneNames.Num() == 0 || modification.WhitelistedBoneNames.Contains(boneName));
-		bWithinRange = (modification.MinimumRange <= 0 || (damageOrigin - GetOwner()->GetActorLocation()).Length() >= modification.MinimumRange)
-			&& (modification.MaximumRange <= 0 || (damageOrigin - GetOwner()->GetActorLocation()).Length() <= modification.MaximumRange);
-		bCorrectDamageChannel = (damageChannel == modification.DamageChannel || modification.DamageChannel == AllChannels);
-		if (bWhiteListedDamageType && bWithinRange && bCorrectBone && bCorrectDamageChannel) {
-
-			if (modification.ModificationType == EIncomingDamageModificationType::Override_Damage) {
-				return modification.Magnitude;
-			}
-			if (modification.ModificationType == EIncomingDamageModificationType::Modify_From_DamageType) {
-				if (UKismetSystemLibrary::DoesImplementInterface(DamageType->GetClass()->GetDefaultObject(), UDamageTypeModificationInterface::StaticClass())) {
-					modifiedDamage = IDamageTypeModificationInterface::Execute_ModifyDamage(DamageType->GetClass()->GetDefaultObject(), damageReceived, GetOwner());
-				}
-			}
-			if (modification.ModificationType == EIncomingDamageModificationType::Add_Damage) {
-				modifiedDamage = modifiedDamage + modification.Magnitude;
-			}
-			if (modification.ModificationType == EIncomingDamageModificationType::Multiply_Damage) {
-				modifiedDamage = modifiedDamage * modification.Magnitude;
-			}
+	UpdateCompiledRules();
+	const std::vector<ResourceCore::FModificationRule>& compiledRules = GetActiveCompiledRules();
+	if (compiledRules.empty()) {
+		return damageReceived;
+	}
+	ResourceCore::FDamageQuery query;
+	query.Damage = damageReceived;
+	query.Channel = ResourceCore::ToCoreChannel(damageChannel);
+	query.DamageType = ResourceCore::MakeTypeId(DamageType);
+	query.Bone = ResourceCore::MakeNameId(boneName);
+	query.Distance = (damageOrigin - GetOwner()->GetActorLocation()).Length();
+	const ResourceCore::FDamageTypeOps ops = ResourceCore::MakeDamageTypeOps(GetOwner());
+	if (GetSimulationLOD() != RSL_Full && IsInGameThread()) {
+		// Repeated hits of the same kind skip rule matching. The steps give the same result as the rules.
+		const TPair<uint8, ResourceCore::FTypeId> key(static_cast<uint8>(query.Channel), query.DamageType);
+		FCachedDamageSteps* cached = DamageStepCache.Find(key);
+		if (!cached) {
+			cached = &DamageStepCache.Add(key);
+			cached->bCacheable = ResourceCore::FilterRules(compiledRules.data(), static_cast<int32>(compiledRules.size()), query.Channel, query.DamageType, ops, cached->Steps);
+		}
+		if (cached->bCacheable) {
+			return ResourceCore::ApplyDamageSteps(cached->Steps, query, ops);
 		}
 	}
-	return modifiedDamage;
+	return ResourceCore::ModifyDamage(compiledRules, query, ops);
+}
+void UHealthResource::OnSimulationLODChanged(EResourceSimulationLOD oldLOD) {
+	Super::OnSimulationLODChanged(oldLOD);
+	if (GetSimulationLOD() == RSL_Full) {
+		DamageStepCache.Reset();
+	}
+}
+void UHealthResource::ApplyReplicationPolicy() {
+	Super::ApplyReplicationPolicy();
+	const ELifetimeCondition rulesCondition = AreModificationRulesOwnerOnly() ? COND_OwnerOnly : COND_None;
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UHealthResource, ModificationRules, rulesCondition);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UHealthResource, bUsesArchetypeRules, rulesCondition);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UHealthResource, ArchetypeRulesData, rulesCondition);
+	const ELifetimeCondition damageCondition = GetReplicationPolicy() == RRP_Everyone ? COND_None : COND_OwnerOnly;
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UHealthResource, LastDamageCauser, damageCondition);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UHealthResource, LastLocationHitFrom, damageCondition);
 }
 bool UHealthResource::ModificationAcceptsDamageType(FIncomingDamageModification modification, const UDamageType* damageType) const {
-	if (modification.WhitelistedDamageTypes.Num() <= 0 || modification.WhitelistedDamageTypes.Contains(damageType->GetClass())) { return true; }
-	
-	if (!modification.bWhitelistChildDamageTypes) { return false; }
-
-	for (TSubclassOf<UDamageType> damageClass : modification.WhitelistedDamageTypes) {
-		if (damageType->GetClass()->IsChildOf(damageClass))
-			return true;
+	return ResourceCore::AcceptsDamageType(ResourceCore::MakeRule(modification), ResourceCore::MakeTypeId(damageType), ResourceCore::MakeDamageTypeOps(GetOwner()));
+}
+void UHealthResource::UpdateCompiledRules() const {
+	if (bUsesArchetypeRules && IsValid(Archetype)) {
+		// Builds the archetype's shared rules once for every instance with the same default data.
+		ArchetypeRules = &Archetype->GetSharedRules(ArchetypeRulesData);
+		return;
 	}
-
-	return false;
+	if (!bCompiledRulesDirty) {
+		return;
+	}
+	ResourceCore::MakeRules(ModificationRules, CompiledRules);
+	bCompiledRulesDirty = false;
+	DamageStepCache.Reset();
+}
+const TArray<FIncomingDamageModification>& UHealthResource::GetActiveRules() const {
+	return bUsesArchetypeRules && IsValid(Archetype) ? Archetype->GetSharedRules(ArchetypeRulesData).Rules : ModificationRules;
+}
+const std::vector<ResourceCore::FModificationRule>& UHealthResource::GetActiveCompiledRules() const {
+	return bUsesArchetypeRules && ArchetypeRules ? ArchetypeRules->CompiledRules : CompiledRules;
+}
+TArray<FIncomingDamageModification>& UHealthResource::GetMutableModificationRules() {
+	DetachArchetypeRules();
+	bCompiledRulesDirty = true;
+	return ModificationRules;
+}
+void UHealthResource::OnRep_ModificationRules() {
+	bCompiledRulesDirty = true;
+}
+void UHealthResource::DetachArchetypeRules() {
+	if (!bUsesArchetypeRules) {
+		return;
+	}
+	if (IsValid(Archetype)) {
+		ModificationRules = Archetype->GetSharedRules(ArchetypeRulesData).Rules;
+	}
+	bUsesArchetypeRules = false;
+	ArchetypeRulesData = nullptr;
+	ArchetypeRules = nullptr;
+	bCompiledRulesDirty = true;
 }
 void UHealthResource::GiveModifier(FIncomingDamageModification newModifier, int insertAt) {
+	DetachArchetypeRules();
 	if (insertAt >= 0) {
 		ModificationRules.Insert(newModifier, insertAt);
 	}
 	else {
 		ModificationRules.Add(newModifier);
 	}
-	ModificationChanged(newModifier, true);
-	
+	bCompiledRulesDirty = true;
+	SendModificationChanged(newModifier, true);
+
 }
 void UHealthResource::GiveModificationData(UDamageModificationData* modificationData, int beginInsertAt) {
 	if (!IsValid(modificationData)) { return; }
@@ -175,22 +274,94 @@ void UHealthResource::GiveModificationData(UDamageModificationData* modification
 			GiveModifier(modificationData->Modifications[i], beginInsertAt + i);
 		}
 	}
-	ModificationDataAdded(modificationData);
+	SendModificationDataAdded(modificationData);
 }
 void UHealthResource::RemoveModifier(FName modifierName) {
+	DetachArchetypeRules();
 	for (int index = 0; index < ModificationRules.Num(); index++) {
 		if (ModificationRules[index].ModificationName == modifierName) {
 			const FIncomingDamageModification mod = ModificationRules[index];
 			ModificationRules.RemoveAt(index);
-			ModificationChanged(mod, false);
+			bCompiledRulesDirty = true;
+			SendModificationChanged(mod, false);
 		}
 	}
 }
-void UHealthResource::ModificationDataAdded_Implementation(const UDamageModificationData* modificationData) {
+void UHealthResource::ApplyModifiedDamage(float modifiedDamage, EIncomingDamageChannel damageChannel, const UDamageType* DamageType, FName boneName, FVector damageOrigin, FVector hitLocation, AController* InstigatedBy, AActor* DamageCauser) {
+	LastDamageCauser = DamageCauser;
+	DrainResource(modifiedDamage);
+	LastLocationHitFrom = damageOrigin;
+	switch (damageChannel) {
+	case EIncomingDamageChannel::PointDamage:
+		OnPointDamageTaken.Broadcast(GetOwner(), modifiedDamage, InstigatedBy, hitLocation, nullptr, boneName, (hitLocation - damageOrigin).GetSafeNormal(), DamageType, DamageCauser);
+		BroadcastPointDamageNative(GetOwner(), modifiedDamage, InstigatedBy, hitLocation, nullptr, boneName, (hitLocation - damageOrigin).GetSafeNormal(), DamageType, DamageCauser);
+		break;
+	case EIncomingDamageChannel::RadialDamage: {
+		FHitResult hitInfo;
+		hitInfo.Location = hitLocation;
+		hitInfo.ImpactPoint = hitLocation;
+		hitInfo.BoneName = boneName;
+		OnRadialDamageTaken.Broadcast(GetOwner(), modifiedDamage, DamageType, damageOrigin, hitInfo, InstigatedBy, DamageCauser);
+		BroadcastRadialDamageNative(GetOwner(), modifiedDamage, DamageType, damageOrigin, hitInfo, InstigatedBy, DamageCauser);
+		break;
+	}
+	default:
+		OnGenericDamageTaken.Broadcast(GetOwner(), modifiedDamage, DamageType, InstigatedBy, DamageCauser);
+		BroadcastGenericDamageNative(GetOwner(), modifiedDamage, DamageType, InstigatedBy, DamageCauser);
+		break;
+	}
+}
+bool UHealthResource::AreModificationRulesOwnerOnly() const {
+	return bModificationRulesOwnerOnly || GetReplicationPolicy() != RRP_Everyone;
+}
+void UHealthResource::SendModificationDataAdded(const UDamageModificationData* modificationData) {
+	if (!AreModificationRulesOwnerOnly()) {
+		ModificationDataAdded(modificationData);
+		return;
+	}
+	ReceiveModificationDataAdded(modificationData);
+	if (HasRemoteOwner()) {
+		ModificationDataAdded_Owner(modificationData);
+	}
+}
+void UHealthResource::SendModificationChanged(const FIncomingDamageModification& modification, bool bAdded) {
+	if (!AreModificationRulesOwnerOnly()) {
+		ModificationChanged(modification, bAdded);
+		return;
+	}
+	ReceiveModificationChanged(modification, bAdded);
+	if (HasRemoteOwner()) {
+		ModificationChanged_Owner(modification, bAdded);
+	}
+}
+void UHealthResource::ReceiveModificationDataAdded(const UDamageModificationData* modificationData) {
 	OnModificationDataAdded.Broadcast(modificationData);
+	if (OnModificationDataAddedNative.IsBound()) {
+		OnModificationDataAddedNative.Broadcast(modificationData);
+	}
 }
-void UHealthResource::ModificationChanged_Implementation(FIncomingDamageModification modification, bool bAdded) {
+void UHealthResource::ReceiveModificationChanged(const FIncomingDamageModification& modification, bool bAdded) {
 	bAdded ? OnModificationAdded.Broadcast(modification) : OnModificationRemoved.Broadcast(modification);
+	FOnModificationNative& nativeDelegate = bAdded ? OnModificationAddedNative : OnModificationRemovedNative;
+	if (nativeDelegate.IsBound()) {
+		nativeDelegate.Broadcast(modification);
+	}
+}
+void UHealthResource::ModificationDataAdded_Implementation(const UDamageModificationData* modificationData) {
+	RESOURCE_NET_STAT_RPC(this, "ModificationDataAdded");
+	ReceiveModificationDataAdded(modificationData);
+}
+void UHealthResource::ModificationChanged_Implementation(FIncomingDamageModification modification, bool bAdded) {
+	RESOURCE_NET_STAT_RPC(this, "ModificationChanged");
+	ReceiveModificationChanged(modification, bAdded);
+}
+void UHealthResource::ModificationDataAdded_Owner_Implementation(const UDamageModificationData* modificationData) {
+	RESOURCE_NET_STAT_RPC(this, "ModificationDataAdded_Owner");
+	ReceiveModificationDataAdded(modificationData);
+}
+void UHealthResource::ModificationChanged_Owner_Implementation(FIncomingDamageModification modification, bool bAdded) {
+	RESOURCE_NET_STAT_RPC(this, "ModificationChanged_Owner");
+	ReceiveModificationChanged(modification, bAdded);
 }
 // Damage Binders
 void UHealthResource::OnAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
@@ -203,6 +374,7 @@ void UHealthResource::OnAnyDamage(AActor* DamagedActor, float Damage, const UDam
 	DrainResource(modifiedDamage);
 	LastLocationHitFrom = DamageCauser->GetActorLocation();
 	OnGenericDamageTaken.Broadcast(GetOwner(), modifiedDamage, DamageType, InstigatedBy, DamageCauser);
+	BroadcastGenericDamageNative(GetOwner(), modifiedDamage, DamageType, InstigatedBy, DamageCauser);
 	if (bDebug) {
 		FString debugString = FString(GetNameSafe(this)).Append(": Damage received in Any Damage: ").Append(FString::SanitizeFloat(Damage));
 		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 1.f, FColor::Green, *debugString);
@@ -215,6 +387,7 @@ void UHealthResource::OnPointDamage(AActor* DamagedActor, float Damage, AControl
 	DrainResource(modifiedDamage);
 	LastLocationHitFrom = DamageCauser->GetActorLocation();
 	OnPointDamageTaken.Broadcast(DamagedActor, modifiedDamage, InstigatedBy, HitLocation, HitComponent, BoneName, ShotFromDirection, DamageType, DamageCauser);
+	BroadcastPointDamageNative(DamagedActor, modifiedDamage, InstigatedBy, HitLocation, HitComponent, BoneName, ShotFromDirection, DamageType, DamageCauser);
 	if (bDebug) {
 		FString debugString = FString(GetNameSafe(this)).Append(": Point  Damage: ").Append(FString::SanitizeFloat(modifiedDamage));
 		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 1.f, FColor::Green, *debugString);
@@ -227,6 +400,7 @@ void UHealthResource::OnRadialDamage(AActor* DamagedActor, float Damage, const U
 	DrainResource(modifiedDamage);
 	LastLocationHitFrom = Origin;
 	OnRadialDamageTaken.Broadcast(DamagedActor, modifiedDamage, DamageType, Origin, HitInfo, InstigatedBy, DamageCauser);
+	BroadcastRadialDamageNative(DamagedActor, modifiedDamage, DamageType, Origin, HitInfo, InstigatedBy, DamageCauser);
 	if (bDebug) {
 		FString debugString = FString(GetNameSafe(this)).Append(": Radial Damage: ").Append(FString::SanitizeFloat(modifiedDamage));
 		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 1.f, FColor::Green, *debugString);
@@ -243,18 +417,68 @@ void UHealthResource::BindDamageDelegates() {
 }
 
 void UHealthResource::GenericDamageTaken_Implementation(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+	RESOURCE_NET_STAT_RPC(this, "GenericDamageTaken");
 	if (!IsServer()) {
 		OnGenericDamageTaken.Broadcast(DamagedActor, Damage, DamageType, InstigatedBy, DamageCauser);
+		BroadcastGenericDamageNative(DamagedActor, Damage, DamageType, InstigatedBy, DamageCauser);
 	}
 }
 void UHealthResource::PointDamageTaken_Implementation(AActor* DamagedActor, float Damage, AController* InstigatedBy, FVector HitLocation, UPrimitiveComponent* HitComponent, FName BoneName, FVector ShotFromDirection, const UDamageType* DamageType, AActor* DamageCauser) {
+	RESOURCE_NET_STAT_RPC(this, "PointDamageTaken");
 	if (!IsServer()) {
 		OnPointDamageTaken.Broadcast(DamagedActor, Damage, InstigatedBy, HitLocation, HitComponent, BoneName, ShotFromDirection, DamageType, DamageCauser);
+		BroadcastPointDamageNative(DamagedActor, Damage, InstigatedBy, HitLocation, HitComponent, BoneName, ShotFromDirection, DamageType, DamageCauser);
 	}
 }
 void UHealthResource::RadialDamageTaken_Implementation(AActor* DamagedActor, float Damage, const UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, AController* InstigatedBy, AActor* DamageCauser) {
+	RESOURCE_NET_STAT_RPC(this, "RadialDamageTaken");
 	if (!IsServer()) {
 		OnRadialDamageTaken.Broadcast(DamagedActor, Damage, DamageType, Origin, HitInfo, InstigatedBy, DamageCauser);
+		BroadcastRadialDamageNative(DamagedActor, Damage, DamageType, Origin, HitInfo, InstigatedBy, DamageCauser);
 	}
 }
-
+void UHealthResource::BroadcastGenericDamageNative(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) {
+	if (!OnDamageTakenNative.IsBound()) {
+		return;
+	}
+	FResourceDamageEvent damageEvent;
+	damageEvent.DamagedActor = DamagedActor;
+	damageEvent.Damage = Damage;
+	damageEvent.Channel = EIncomingDamageChannel::GenericDamage;
+	damageEvent.DamageType = DamageType;
+	damageEvent.InstigatedBy = InstigatedBy;
+	damageEvent.DamageCauser = DamageCauser;
+	OnDamageTakenNative.Broadcast(damageEvent);
+}
+void UHealthResource::BroadcastPointDamageNative(AActor* DamagedActor, float Damage, AController* InstigatedBy, FVector HitLocation, UPrimitiveComponent* HitComponent, FName BoneName, FVector ShotFromDirection, const UDamageType* DamageType, AActor* DamageCauser) {
+	if (!OnDamageTakenNative.IsBound()) {
+		return;
+	}
+	FResourceDamageEvent damageEvent;
+	damageEvent.DamagedActor = DamagedActor;
+	damageEvent.Damage = Damage;
+	damageEvent.Channel = EIncomingDamageChannel::PointDamage;
+	damageEvent.DamageType = DamageType;
+	damageEvent.InstigatedBy = InstigatedBy;
+	damageEvent.DamageCauser = DamageCauser;
+	damageEvent.HitLocation = HitLocation;
+	damageEvent.HitComponent = HitComponent;
+	damageEvent.BoneName = BoneName;
+	damageEvent.ShotFromDirection = ShotFromDirection;
+	OnDamageTakenNative.Broadcast(damageEvent);
+}
+void UHealthResource::BroadcastRadialDamageNative(AActor* DamagedActor, float Damage, const UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, AController* InstigatedBy, AActor* DamageCauser) {
+	if (!OnDamageTakenNative.IsBound()) {
+		return;
+	}
+	FResourceDamageEvent damageEvent;
+	damageEvent.DamagedActor = DamagedActor;
+	damageEvent.Damage = Damage;
+	damageEvent.Channel = EIncomingDamageChannel::RadialDamage;
+	damageEvent.DamageType = DamageType;
+	damageEvent.InstigatedBy = InstigatedBy;
+	damageEvent.DamageCauser = DamageCauser;
+	damageEvent.Origin = Origin;
+	damageEvent.HitInfo = &HitInfo;
+	OnDamageTakenNative.Broadcast(damageEvent);
+}
@@ -7,8 +7,14 @@
 #include "Components/WidgetComponent.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/SceneComponent.h"
+#include "Subsystems/OverheadBarBatchRenderer.h"
+#include "Subsystems/OverheadBarManager.h"
+#include "Subsystems/ResourceRPCIntake.h"
+#include "Subsystems/ResourceUISetupQueue.h"
+#include "Subsystems/ResourceUISignificance.h"
+#include "Widgets/ResourceWidgetBase.h"
 
-#include "Runtime/CoreUObject/Public/UObject/ConstructorHelpers.h"
+#include "Engine/AssetManager.h"
 #include "Net/UnrealNetwork.h"
 
 //MP Reqs
@@ -21,55 +27,107 @@ void UHealthResourceWithUI::ChangeWidgetSettings(bool bUseOnscreen, EOverheadWid
         return;
     }
     if (GetOwner()->HasAuthority()) {
-        bEnableOnscreen = bUseOnscreen;
-        UpdateOnscreenWidgetVisibilityFromServer();
-        OverheadWidgetSettings = useOverhead;
-        UpdateOverheadWidgetVisibilityFromServer();
+        SetWidgetSettings(bUseOnscreen, useOverhead);
     }
     else {
         ChangeWidgetSettingsOnServer(bUseOnscreen, useOverhead);
     }
 }
 
-UHealthResourceWithUI::UHealthResourceWithUI() {
-    //FString pluginContentDir = IPluginManager::Get().FindPlugin(TEXT("ResourceCompPlugin"))->GetContentDir();
-    
-    /* Setup default OnScreen Widget Class*/ {
-        const FString defaultOnScreenDirectory = ("/Script/UMGEditor.WidgetBlueprint'/ResourceCompPlugin/UI/WBP_Screen_Widget.WBP_Screen_Widget_C'");
-        static ConstructorHelpers::FClassFinder<UUserWidget> defaultOnScreen(*defaultOnScreenDirectory);
-        if (defaultOnScreen.Succeeded()) {
-            OnScreenWidgetClass = defaultOnScreen.Class;
-        }
-    }
-    
-    /* Setup default World Widget Class*/ {
-        const FString defaultOverheadDirectory = ("/Script/UMGEditor.WidgetBlueprint'/ResourceCompPlugin/UI/WBP_World_Widget.WBP_World_Widget_C'");
-        static ConstructorHelpers::FClassFinder<UUserWidget> defaultWorldWidget(*defaultOverheadDirectory);
-        if (defaultWorldWidget.Succeeded()) {
-            OverheadWidgetClass = defaultWorldWidget.Class;
-        }
+bool UHealthResourceWithUI::ShouldShowOverheadTo(const APlayerController* viewer) const {
+    const APawn* pawn = GetOwner<APawn>();
+    const bool bViewerIsOwner = IsValid(viewer) && IsValid(pawn) && pawn->GetController() == viewer;
+    switch (OverheadWidgetSettings) {
+    case EOverheadWidgetVisibility::OHWO_ShowOnlyOnPossessedPlayer:
+        return bViewerIsOwner;
+    case EOverheadWidgetVisibility::OHWO_ShowOnlyOnOther:
+        return !bViewerIsOwner;
+    case EOverheadWidgetVisibility::OHWO_ShowOnAll:
+        return true;
+    default:
+        return false;
     }
+}
 
-    /* Setup default Overhead Widget Material*/ {
-        const FString defaultOverheadMatDirectory = ("/Script/Engine.Material'/ResourceCompPlugin/Materials/M_OverheadWidgetMaterial.M_OverheadWidgetMaterial'");
-        static ConstructorHelpers::FObjectFinder<UMaterialInterface> defaultOverheadMaterial(*defaultOverheadMatDirectory);
-        if (defaultOverheadMaterial.Succeeded()) {
-            OverheadWidgetMaterial = defaultOverheadMaterial.Object;
-        }
+void UHealthResourceWithUI::SetWidgetResource(UUserWidget* widget, UResourceComponentBase* resource) {
+    if (!IsValid(widget)) {
+        return;
+    }
+    if (UResourceWidgetBase* resourceWidget = Cast<UResourceWidgetBase>(widget)) {
+        resourceWidget->BindResource(resource);
+        return;
+    }
+    // Widgets that do not derive from UResourceWidgetBase may still implement SetResourceComponent.
+    UFunction* setResourceCompFunction = widget->FindFunction(FName("SetResourceComponent"));
+    if (IsValid(setResourceCompFunction)) {
+        //The parameter value apparently has to be in a struct. WHYYYYY
+        struct FArgStruct {
+            UResourceComponentBase* Arg;
+        };
+        FArgStruct argParam;
+        argParam.Arg = resource;
+        widget->ProcessEvent(setResourceCompFunction, &argParam);
     }
-    ///
-    
+}
+
+UHealthResourceWithUI::UHealthResourceWithUI() {
+    // Soft references, so servers and cold starts do not load the UI assets with the class.
+    OnScreenWidgetClass = TSoftClassPtr<UUserWidget>(FSoftObjectPath(TEXT("/ResourceCompPlugin/UI/WBP_Screen_Widget.WBP_Screen_Widget_C")));
+    OverheadWidgetClass = TSoftClassPtr<UUserWidget>(FSoftObjectPath(TEXT("/ResourceCompPlugin/UI/WBP_World_Widget.WBP_World_Widget_C")));
+    OverheadWidgetMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/ResourceCompPlugin/Materials/M_OverheadWidgetMaterial.M_OverheadWidgetMaterial")));
 }
 
 void UHealthResourceWithUI::BeginPlay() {
     Super::BeginPlay();
-    
-    TryCreateOverheadWidgetComponent();
 
-    if (IsValid(GetOwner())) {
-        if (GetOwner()->HasAuthority()) {
-            UpdateOverheadWidgetVisibilityFromServer();
+    // Clients apply the replicated settings once their UI exists, and again whenever they change.
+    if (GetNetMode() != NM_DedicatedServer) {
+        RequestUIAssets();
+    }
+}
+
+void UHealthResourceWithUI::RequestUIAssets() {
+    TArray<FSoftObjectPath> assetsToLoad;
+    if (OnScreenWidgetClass.IsPending()) {
+        assetsToLoad.Add(OnScreenWidgetClass.ToSoftObjectPath());
+    }
+    if (OverheadRenderMode != EOverheadBarRenderMode::OHRM_Batched) {
+        if (OverheadWidgetClass.IsPending()) {
+            assetsToLoad.Add(OverheadWidgetClass.ToSoftObjectPath());
+        }
+        if (OverheadWidgetMaterial.IsPending()) {
+            assetsToLoad.Add(OverheadWidgetMaterial.ToSoftObjectPath());
+        }
+    }
+    if (assetsToLoad.IsEmpty()) {
+        SetupUI();
+        return;
+    }
+    if (OverheadRenderMode == EOverheadBarRenderMode::OHRM_PerActorWidget && OverheadWidgetSettings != EOverheadWidgetVisibility::OHWO_OverheadDisabled) {
+        SetOverheadPlaceholder(true);
+    }
+    UIAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(assetsToLoad, FStreamableDelegate::CreateUObject(this, &UHealthResourceWithUI::SetupUI));
+}
+
+void UHealthResourceWithUI::SetupUI() {
+    if (!HasBegunPlay()) {
+        return;
+    }
+    if (OverheadRenderMode == EOverheadBarRenderMode::OHRM_Pooled) {
+        if (UOverheadBarManager* overheadBarManager = UOverheadBarManager::Get(this)) {
+            overheadBarManager->Register(this);
+        }
+    }
+    else if (OverheadRenderMode == EOverheadBarRenderMode::OHRM_Batched) {
+        if (UOverheadBarBatchRenderer* batchRenderer = UOverheadBarBatchRenderer::Get(this)) {
+            batchRenderer->Register(this);
         }
+    }
+    else {
+        QueueOverheadWidgetSetup();
+    }
+
+    if (IsValid(GetOwner())) {
         SetOverheadVisibility(OverheadWidgetSettings);
     }
 
@@ -90,6 +148,34 @@ void UHealthResourceWithUI::BeginPlay() {
     }    
 }
 
+void UHealthResourceWithUI::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+    if (UIAssetsHandle.IsValid()) {
+        UIAssetsHandle->CancelHandle();
+        UIAssetsHandle.Reset();
+    }
+    if (bOverheadSetupQueued) {
+        if (UResourceUISetupQueue* setupQueue = UResourceUISetupQueue::Get(this)) {
+            setupQueue->Remove(this);
+        }
+        bOverheadSetupQueued = false;
+    }
+    SetOverheadPlaceholder(false);
+    if (UResourceUISignificance* significance = UResourceUISignificance::Get(this)) {
+        significance->Unregister(this);
+    }
+    if (OverheadRenderMode == EOverheadBarRenderMode::OHRM_Pooled) {
+        if (UOverheadBarManager* overheadBarManager = UOverheadBarManager::Get(this)) {
+            overheadBarManager->Unregister(this);
+        }
+    }
+    else if (OverheadRenderMode == EOverheadBarRenderMode::OHRM_Batched) {
+        if (UOverheadBarBatchRenderer* batchRenderer = UOverheadBarBatchRenderer::Get(this)) {
+            batchRenderer->Unregister(this);
+        }
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void UHealthResourceWithUI::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
     DOREPLIFETIME(UHealthResourceWithUI, bEnableOnscreen);
@@ -98,29 +184,24 @@ void UHealthResourceWithUI::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>
 }
 
 void UHealthResourceWithUI::TryCreateOnScreenWidget(APlayerController* owningPlayer) {
-    if (IsValid(OnScreenWidget) || !IsValid(GetOwner<APawn>()) || !IsValid(OnScreenWidgetClass) || !(GetOwner<APawn>()->IsLocallyControlled())) {
+    if (IsValid(OnScreenWidget) || !IsValid(GetOwner<APawn>()) || !OnScreenWidgetClass.Get() || !(GetOwner<APawn>()->IsLocallyControlled())) {
         return;
     }
     else {
-        OnScreenWidget = UWidgetBlueprintLibrary::Create(GetWorld(), OnScreenWidgetClass, owningPlayer);
-        if (IsValid(OnScreenWidget)) {
-                        
-            /* Sets a reference to this on the widget. */
-            UFunction* setResourceCompFunction = OnScreenWidget->FindFunction(FName("SetResourceComponent"));
-            if (IsValid(setResourceCompFunction)) {
-                struct FArgStruct {
-                    UResourceComponentBase* Arg;
-                };
-                FArgStruct argParam;
-                argParam.Arg = this;
-                OnScreenWidget->ProcessEvent(setResourceCompFunction, &argParam);
-            }
-        }
+        OnScreenWidget = UWidgetBlueprintLibrary::Create(GetWorld(), OnScreenWidgetClass.Get(), owningPlayer);
+        /* Sets a reference to this on the widget. */
+        SetWidgetResource(OnScreenWidget, this);
     }
 }
 
 void UHealthResourceWithUI::TryCreateOverheadWidgetComponent() {
-    if (IsValid(OverheadWidgetComponent) || !IsValid(GetOwner()) || !IsValid(OverheadWidgetClass)) {
+    // Nothing is drawn on a dedicated server, pooled bars come from the manager, a queued widget is created by the queue,
+    // and a disabled widget is created once enabled.
+    if (GetNetMode() == NM_DedicatedServer || OverheadRenderMode != EOverheadBarRenderMode::OHRM_PerActorWidget || bOverheadSetupQueued
+        || (!IsValid(OverheadWidgetComponent) && OverheadWidgetSettings == EOverheadWidgetVisibility::OHWO_OverheadDisabled)) {
+        return;
+    }
+    if (IsValid(OverheadWidgetComponent) || !IsValid(GetOwner()) || !OverheadWidgetClass.Get()) {
         if (IsValid(OverheadWidgetComponent)) {
             if (APawn* pawn = GetOwner<APawn>()) {
                 if (APlayerController* pCon = pawn->GetController<APlayerController>()) {
@@ -140,13 +221,12 @@ void UHealthResourceWithUI::TryCreateOverheadWidgetComponent() {
         overheadRoot->SetUsingAbsoluteScale(true);
         OverheadWidgetComponent = Cast<UWidgetComponent>(GetOwner()->AddComponentByClass(UWidgetComponent::StaticClass(), true, GetOwner()->GetActorTransform(), true));
         if (IsValid(OverheadWidgetComponent)) {
-            OverheadWidgetComponent->SetIsReplicated(true);
             OverheadWidgetComponent->SetWidgetSpace(bUseWorldSpace ? EWidgetSpace::World : EWidgetSpace::Screen);
             OverheadWidgetComponent->SetDrawAtDesiredSize(bDrawAtDesiredSize);
             OverheadWidgetComponent->SetDrawSize(DrawSize);
-            OverheadWidgetComponent->SetWidgetClass(OverheadWidgetClass);
+            OverheadWidgetComponent->SetWidgetClass(OverheadWidgetClass.Get());
             OverheadWidgetComponent->SetComponentTickEnabled(false);
-            OverheadWidgetComponent->SetMaterial(0, OverheadWidgetMaterial);
+            OverheadWidgetComponent->SetMaterial(0, OverheadWidgetMaterial.Get());
             GetOwner()->FinishAddComponent(OverheadWidgetComponent, false, FTransform());
             overheadRoot->RegisterComponent();
             OverheadWidgetComponent->AttachToComponent(overheadRoot, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
@@ -161,50 +241,122 @@ void UHealthResourceWithUI::TryCreateOverheadWidgetComponent() {
 
             /* Sets a reference to this on the widget. */
             OverheadWidget = OverheadWidgetComponent->GetWidget();
-            if (IsValid(OverheadWidget)) {
-                /**/
-                UFunction* setResourceCompFunction = OverheadWidget->FindFunction(FName("SetResourceComponent"));
-                if (IsValid(setResourceCompFunction)) {
-                    //The parameter value apparently has to be in a struct. WHYYYYY
-                    struct FArgStruct {
-                        UResourceComponentBase* Arg;
-                    };
-                    FArgStruct argParam;
-                    argParam.Arg = this;
-                    OverheadWidget->ProcessEvent(setResourceCompFunction, &argParam);
-                }
-                /**/
+            SetWidgetResource(OverheadWidget, this);
+
+            if (UResourceUISignificance* significance = UResourceUISignificance::Get(this)) {
+                significance->Register(this);
             }
         }
     }
 }
 
-void UHealthResourceWithUI::ChangeWidgetSettingsOnServer_Implementation(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead) {
-    bEnableOnscreen = bUseOnscreen;
-    UpdateOnscreenWidgetVisibilityFromServer();
-    OverheadWidgetSettings = useOverhead;
-    UpdateOverheadWidgetVisibilityFromServer();
+void UHealthResourceWithUI::QueueOverheadWidgetSetup() {
+    if (bOverheadSetupQueued) {
+        return;
+    }
+    UResourceUISetupQueue* setupQueue = UResourceUISetupQueue::IsEnabled() ? UResourceUISetupQueue::Get(this) : nullptr;
+    if (IsValid(setupQueue) && OverheadRenderMode == EOverheadBarRenderMode::OHRM_PerActorWidget && !IsValid(OverheadWidgetComponent)
+        && OverheadWidgetSettings != EOverheadWidgetVisibility::OHWO_OverheadDisabled) {
+        bOverheadSetupQueued = true;
+        setupQueue->Enqueue(this);
+        SetOverheadPlaceholder(true);
+    }
+    else {
+        TryCreateOverheadWidgetComponent();
+        SetOverheadPlaceholder(false);
+    }
 }
 
-void UHealthResourceWithUI::UpdateOverheadWidgetVisibilityFromServer_Implementation() {
+void UHealthResourceWithUI::RunQueuedUISetup() {
+    bOverheadSetupQueued = false;
     TryCreateOverheadWidgetComponent();
+    SetOverheadPlaceholder(false);
     SetOverheadVisibility(OverheadWidgetSettings);
 }
 
-void UHealthResourceWithUI::UpdateOnscreenWidgetVisibilityFromServer_Implementation() {
-    if (APlayerController* pCon = GetOwner<APawn>()->GetController<APlayerController>()) {
+void UHealthResourceWithUI::SetOverheadPlaceholder(bool bEnable) {
+    if (bEnable == bOverheadPlaceholder) {
+        return;
+    }
+    bOverheadPlaceholder = bEnable;
+    if (UOverheadBarBatchRenderer* batchRenderer = UOverheadBarBatchRenderer::Get(this)) {
+        if (bEnable) {
+            batchRenderer->Register(this);
+        }
+        else {
+            batchRenderer->Unregister(this);
+        }
+    }
+}
+
+bool UHealthResourceWithUI::ChangeWidgetSettingsOnServer_Validate(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead) {
+    return useOverhead <= EOverheadWidgetVisibility::OHWO_ShowOnAll;
+}
+
+void UHealthResourceWithUI::ChangeWidgetSettingsOnServer_Implementation(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead) {
+    if (UResourceRPCIntake* intake = UResourceRPCIntake::Get(this)) {
+        intake->SubmitWidgetSettings(this, bUseOnscreen, useOverhead);
+    }
+}
+
+bool UHealthResourceWithUI::CanModifyDamageOffGameThread() const {
+    // Does not override ModifyDamage.
+    return IsNearestNativeClass(UHealthResourceWithUI::StaticClass());
+}
+
+void UHealthResourceWithUI::ApplyIntakeRequests(const FResourceIntakeRequests& requests) {
+    Super::ApplyIntakeRequests(requests);
+    if (requests.bHasWidgetSettings) {
+        SetWidgetSettings(requests.bUseOnscreen, static_cast<EOverheadWidgetVisibility>(requests.OverheadVisibility));
+    }
+}
+
+void UHealthResourceWithUI::SetWidgetSettings(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead) {
+    const bool bOnscreenChanged = bEnableOnscreen != bUseOnscreen;
+    const bool bOverheadChanged = OverheadWidgetSettings != useOverhead;
+    bEnableOnscreen = bUseOnscreen;
+    OverheadWidgetSettings = useOverhead;
+    if (GetNetMode() == NM_DedicatedServer) {
+        return;
+    }
+    if (bOnscreenChanged) {
+        OnRep_EnableOnscreen();
+    }
+    if (bOverheadChanged) {
+        OnRep_OverheadWidgetSettings();
+    }
+}
+
+void UHealthResourceWithUI::OnRep_EnableOnscreen() {
+    // Before BeginPlay, SetupUI applies the replicated value.
+    APawn* owningPawn = GetOwner<APawn>();
+    if (!HasBegunPlay() || !IsValid(owningPawn)) {
+        return;
+    }
+    if (APlayerController* pCon = owningPawn->GetController<APlayerController>()) {
         if (pCon->IsLocalPlayerController()) {
             TryCreateOnScreenWidget(pCon);
-            if (IsValid(OnScreenWidget) && bEnableOnscreen) {
-                OnScreenWidget->AddToViewport(ZOrder);
-            }
-            else {
-                OnScreenWidget->RemoveFromParent();
+            if (IsValid(OnScreenWidget)) {
+                if (bEnableOnscreen) {
+                    OnScreenWidget->AddToViewport(ZOrder);
+                }
+                else {
+                    OnScreenWidget->RemoveFromParent();
+                }
             }
         }
     }
 }
 
+void UHealthResourceWithUI::OnRep_OverheadWidgetSettings() {
+    if (!HasBegunPlay()) {
+        return;
+    }
+    // A widget created by enabling the overhead goes through the queue too, so a wave of enables does not hitch.
+    QueueOverheadWidgetSetup();
+    SetOverheadVisibility(OverheadWidgetSettings);
+}
+
 void UHealthResourceWithUI::SetOverheadVisibility(EOverheadWidgetVisibility newVisibility) {
     if (!IsValid(OverheadWidgetComponent)) {
         return;
@@ -233,12 +385,11 @@ void UHealthResourceWithUI::OnOwnerControllerChanged(APawn* pawn, AController* o
 
     // Always use world is always on so changes are not needed.
     // The world widget is created on Beginplay so only visibility changes are needed.
-    if (IsValid(GetOwner())) {
-        if (GetOwner()->HasAuthority()) {
-            UpdateOverheadWidgetVisibilityFromServer();
-        }
-        else {
-            SetOverheadVisibility(OverheadWidgetSettings);
+    // Who counts as the owner changed, so the local owner-see flags are refreshed. The settings themselves replicate.
+    SetOverheadVisibility(OverheadWidgetSettings);
+    if (APlayerController* newPlayerController = Cast<APlayerController>(newController)) {
+        if (newPlayerController->IsLocalController() && IsValid(OverheadWidgetComponent)) {
+            OverheadWidgetComponent->SetOwnerPlayer(newPlayerController->GetLocalPlayer());
         }
     }
 
@@ -270,12 +421,5 @@ void UHealthResourceWithUI::OnControllerPossessChange(APawn* OldPawn, APawn* New
             }
         }
     }
-    if (IsValid(GetOwner())) {
-        if (GetOwner()->HasAuthority()) {
-            UpdateOverheadWidgetVisibilityFromServer();
-        }
-        else {
-            SetOverheadVisibility(OverheadWidgetSettings);
-        }
-    }
+    SetOverheadVisibility(OverheadWidgetSettings);
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Copyright LyCH. 2024
+
+
+#include "Components/LiteResourceComponent.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+
+bool FLiteResourceState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+	// Bit 0: regen is scheduled. Bit 1: bFirstRegenTick.
+	uint8 flags = Ar.IsSaving() ? (NextRegenTime >= 0 ? 1 : 0) | (bFirstRegenTick ? 2 : 0) : 0;
+	Ar.SerializeBits(&flags, 2);
+	Ar << Amount;
+	if (flags & 1) {
+		Ar << NextRegenTime;
+	}
+	else if (Ar.IsLoading()) {
+		NextRegenTime = -1.0;
+	}
+	if (Ar.IsLoading()) {
+		bFirstRegenTick = (flags & 2) != 0;
+	}
+	bOutSuccess = true;
+	return true;
+}
+
+ULiteResourceComponent::ULiteResourceComponent() {
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+void ULiteResourceComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(ULiteResourceComponent, State);
+}
+void ULiteResourceComponent::BeginPlay() {
+	Super::BeginPlay();
+	if (CanModify()) {
+		ResourceCore::FResourceState state = ToCoreState(State);
+		state.Current = bRegenBeginsEmpty ? 0.f : MaxAmount;
+		if (state.Current < MaxAmount) {
+			ResourceCore::FLiteResourceCore::RestartRegen(state, GetNow(), GetRegenParams());
+		}
+		Commit(state, state.Current);
+	}
+}
+
+void ULiteResourceComponent::AddResource(float addAmount) {
+	if (!CanModify()) {
+		return;
+	}
+	const double now = GetNow();
+	ResourceCore::FResourceState state = GetPresentState(now);
+	const float oldValue = state.Current;
+	ResourceCore::FLiteResourceCore::Add(state, addAmount, now, GetRegenParams());
+	Commit(state, oldValue);
+}
+void ULiteResourceComponent::DrainResource(float drainAmount) {
+	if (!CanModify()) {
+		return;
+	}
+	const double now = GetNow();
+	ResourceCore::FResourceState state = GetPresentState(now);
+	const float oldValue = state.Current;
+	ResourceCore::FLiteResourceCore::Drain(state, drainAmount, now, GetRegenParams());
+	Commit(state, oldValue);
+}
+void ULiteResourceComponent::AddResourceByPercent(float addPercent, EResourcePercentType percentType) {
+	AddResource((percentType == EResourcePercentType::Current ? GetCurrentAmount() : MaxAmount) * addPercent);
+}
+void ULiteResourceComponent::DrainResourceByPercent(float drainPercent, EResourcePercentType percentType) {
+	DrainResource((percentType == EResourcePercentType::Current ? GetCurrentAmount() : MaxAmount) * drainPercent);
+}
+float ULiteResourceComponent::GetCurrentAmount() const {
+	if (State.NextRegenTime < 0) {
+		return State.Amount;
+	}
+	return GetPresentState(GetNow()).Current;
+}
+
+void ULiteResourceComponent::OnRep_State(const FLiteResourceState& previousState) {
+	if (OnAmountChanged.IsBound()) {
+		const double now = GetNow();
+		ResourceCore::FResourceState previous = ToCoreState(previousState);
+		ResourceCore::FLiteResourceCore::AdvanceRegen(previous, now, GetRegenParams());
+		const float newValue = GetPresentState(now).Current;
+		if (previous.Current != newValue) {
+			OnAmountChanged.Broadcast(this, previous.Current, newValue);
+		}
+	}
+}
+
+ResourceCore::FRegenParams ULiteResourceComponent::GetRegenParams() const {
+	ResourceCore::FRegenParams params;
+	params.Amount = RegenAmount;
+	params.Rate = RegenRate;
+	params.Delay = RegenDelay;
+	params.AdditionalExhaustedDelay = AdditionalExhaustedDelay;
+	params.bRegenAfterDepletion = bRegenAfterDepletion;
+	return params;
+}
+ResourceCore::FResourceState ULiteResourceComponent::ToCoreState(const FLiteResourceState& state) const {
+	ResourceCore::FResourceState coreState;
+	coreState.Current = state.Amount;
+	coreState.Max = MaxAmount;
+	coreState.NextRegenTime = state.NextRegenTime;
+	coreState.bFirstRegenTick = state.bFirstRegenTick;
+	coreState.bDrainDisabled = bDrainDisabled;
+	return coreState;
+}
+ResourceCore::FResourceState ULiteResourceComponent::GetPresentState(double now) const {
+	ResourceCore::FResourceState state = ToCoreState(State);
+	ResourceCore::FLiteResourceCore::AdvanceRegen(state, now, GetRegenParams());
+	return state;
+}
+double ULiteResourceComponent::GetNow() const {
+	const UWorld* world = GetWorld();
+	if (!world) {
+		return 0.0;
+	}
+	const AGameStateBase* gameState = world->GetGameState();
+	return gameState ? gameState->GetServerWorldTimeSeconds() : world->GetTimeSeconds();
+}
+bool ULiteResourceComponent::CanModify() const {
+	// Components without an owner only exist in benchmarks.
+	const AActor* owner = GetOwner();
+	return !owner || owner->HasAuthority();
+}
+void ULiteResourceComponent::Commit(const ResourceCore::FResourceState& state, float oldValue) {
+	State.Amount = state.Current;
+	State.NextRegenTime = state.NextRegenTime;
+	State.bFirstRegenTick = state.bFirstRegenTick;
+	if (oldValue != state.Current && OnAmountChanged.IsBound()) {
+		OnAmountChanged.Broadcast(this, oldValue, state.Current);
+	}
+}
@@ -0,0 +1,147 @@
+// Copyright LyCH. 2024
+
+
+#include "Components/MultiResourceComponent.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+
+ResourceCore::FRegenParams FMultiResourceConfig::GetRegenParams() const {
+	ResourceCore::FRegenParams params;
+	params.Amount = RegenAmount;
+	params.Rate = RegenRate;
+	params.Delay = RegenDelay;
+	params.AdditionalExhaustedDelay = AdditionalExhaustedDelay;
+	params.bRegenAfterDepletion = bRegenAfterDepletion;
+	return params;
+}
+
+UMultiResourceComponent::UMultiResourceComponent() {
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+void UMultiResourceComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UMultiResourceComponent, ReplicatedState);
+}
+void UMultiResourceComponent::BeginPlay() {
+	Super::BeginPlay();
+	// Clients fill this too so the getters are valid before the first update arrives, but keep amounts the initial
+	// bunch already delivered.
+	if (HasAuthority() || ReplicatedState.CurrentAmounts.Num() != Resources.Num()) {
+		ReplicatedState.CurrentAmounts.SetNumUninitialized(Resources.Num());
+		for (int32 i = 0; i < Resources.Num(); i++) {
+			ReplicatedState.CurrentAmounts[i] = Resources[i].bRegenBeginsEmpty ? 0.f : Resources[i].MaxAmount;
+		}
+	}
+	if (!HasAuthority()) {
+		return;
+	}
+	States.SetNum(Resources.Num());
+	RegenParams.SetNum(Resources.Num());
+	const double now = GetNow();
+	for (int32 i = 0; i < Resources.Num(); i++) {
+		States[i].Max = Resources[i].MaxAmount;
+		States[i].Current = ReplicatedState.CurrentAmounts[i];
+		RegenParams[i] = Resources[i].GetRegenParams();
+		if (States[i].Current < States[i].Max) {
+			ResourceCore::RestartRegen(States[i], now, RegenParams[i]);
+		}
+	}
+	ScheduleRegen();
+}
+void UMultiResourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (UWorld* world = GetWorld()) {
+		world->GetTimerManager().ClearTimer(RegenTimer);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 UMultiResourceComponent::FindResourceIndex(FName resourceName) const {
+	return Resources.IndexOfByPredicate([resourceName](const FMultiResourceConfig& config) { return config.ResourceName == resourceName; });
+}
+
+void UMultiResourceComponent::AddResource(int32 resourceIndex, float addAmount) {
+	if (!States.IsValidIndex(resourceIndex)) {
+		return;
+	}
+	Commit(resourceIndex, ResourceCore::Add(States[resourceIndex], addAmount, GetNow(), RegenParams[resourceIndex]));
+	ScheduleRegen();
+}
+void UMultiResourceComponent::DrainResource(int32 resourceIndex, float drainAmount) {
+	if (!States.IsValidIndex(resourceIndex)) {
+		return;
+	}
+	Commit(resourceIndex, ResourceCore::Drain(States[resourceIndex], drainAmount, GetNow(), RegenParams[resourceIndex]));
+	ScheduleRegen();
+}
+void UMultiResourceComponent::SetCanBeDrained(int32 resourceIndex, bool bCanBeDrained) {
+	if (States.IsValidIndex(resourceIndex)) {
+		States[resourceIndex].bDrainDisabled = !bCanBeDrained;
+	}
+}
+
+bool UMultiResourceComponent::HasAuthority() const {
+	const AActor* owner = GetOwner();
+	return owner && owner->HasAuthority();
+}
+double UMultiResourceComponent::GetNow() const {
+	return GetWorld()->GetTimeSeconds();
+}
+void UMultiResourceComponent::Commit(int32 resourceIndex, uint32 events) {
+	const float current = States[resourceIndex].Current;
+	ReplicatedState.CurrentAmounts[resourceIndex] = current;
+	BroadcastEvents(resourceIndex, events, current);
+}
+void UMultiResourceComponent::BroadcastEvents(int32 resourceIndex, uint32 events, float value) {
+	if (events == ResourceCore::Event_None) {
+		return;
+	}
+	UResourceComponentBase::ForEachEventType(events, [this, resourceIndex, value](EResourceEventType type) {
+		if (OnResourceEventNative.IsBound()) {
+			OnResourceEventNative.Broadcast(resourceIndex, type, value);
+		}
+		OnResourceEvent.Broadcast(resourceIndex, type, value);
+	});
+}
+
+void UMultiResourceComponent::OnRegenTimer() {
+	const double now = GetNow();
+	for (int32 i = 0; i < States.Num(); i++) {
+		if (States[i].NextRegenTime >= 0 && States[i].NextRegenTime <= now) {
+			Commit(i, ResourceCore::AdvanceRegen(States[i], now, RegenParams[i]));
+		}
+	}
+	ScheduleRegen();
+}
+void UMultiResourceComponent::ScheduleRegen() {
+	double nextRegenTime = -1.0;
+	for (const ResourceCore::FResourceState& state : States) {
+		if (state.NextRegenTime >= 0 && (nextRegenTime < 0 || state.NextRegenTime < nextRegenTime)) {
+			nextRegenTime = state.NextRegenTime;
+		}
+	}
+	FTimerManager& timerManager = GetWorld()->GetTimerManager();
+	if (nextRegenTime < 0) {
+		timerManager.ClearTimer(RegenTimer);
+		return;
+	}
+	// Resetting a pending timer for the same time is skipped, which is the common case while regenerating.
+	const float delay = FMath::Max(static_cast<float>(nextRegenTime - GetNow()), UE_KINDA_SMALL_NUMBER);
+	if (timerManager.IsTimerActive(RegenTimer) && FMath::IsNearlyEqual(timerManager.GetTimerRemaining(RegenTimer), delay, UE_KINDA_SMALL_NUMBER)) {
+		return;
+	}
+	timerManager.SetTimer(RegenTimer, this, &UMultiResourceComponent::OnRegenTimer, delay, false);
+}
+
+void UMultiResourceComponent::OnRep_ReplicatedState(const FMultiResourceReplicatedState& previousState) {
+	const TArray<float>& amounts = ReplicatedState.CurrentAmounts;
+	for (int32 i = 0; i < amounts.Num() && i < Resources.Num(); i++) {
+		if (!previousState.CurrentAmounts.IsValidIndex(i)) {
+			continue;
+		}
+		BroadcastEvents(i, ResourceCore::GetChangeEvents({ previousState.CurrentAmounts[i], amounts[i] }, Resources[i].MaxAmount), amounts[i]);
+	}
+}
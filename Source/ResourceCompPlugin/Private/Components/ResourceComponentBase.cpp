@@ -2,10 +2,89 @@
 
 
 #include "Components/ResourceComponentBase.h"
+#include "Data/ResourceArchetypeData.h"
+#include "Debug/ResourceNetStats.h"
+#include "Subsystems/ResourceEventSubsystem.h"
+#include "Subsystems/ResourceRPCIntake.h"
+#include "Subsystems/ResourceSimulationLOD.h"
 #include "Net/UnrealNetwork.h"
+#include "HAL/IConsoleManager.h"
+
+#include <limits>
 
 // MP Reqs
 #include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<float> CVarReplicationPercentNearDistance(
+	TEXT("ResourceComp.Replication.PercentNearDistance"),
+	2000.f,
+	TEXT("Players closer than this to a resource's owner receive its percent as soon as it changes."));
+static TAutoConsoleVariable<float> CVarReplicationPercentFarDistance(
+	TEXT("ResourceComp.Replication.PercentFarDistance"),
+	10000.f,
+	TEXT("Players this far from a resource's owner receive its percent every PercentMaxInterval seconds."));
+static TAutoConsoleVariable<float> CVarReplicationPercentMaxInterval(
+	TEXT("ResourceComp.Replication.PercentMaxInterval"),
+	1.f,
+	TEXT("Longest delay between percent updates for players other than the owner. Empty and full are sent immediately."));
+
+namespace {
+	// The bit count, then only that many bits. Same layout as the Iris serializers.
+	void SerializePackedBits(FArchive& Ar, uint32& value) {
+		uint32 bitCount = Ar.IsSaving() ? FResourceReplicatedState::GetPackedBitCount(value) : 0U;
+		Ar.SerializeBits(&bitCount, FResourceReplicatedState::BitCountBits);
+		if (Ar.IsLoading()) {
+			bitCount = FMath::Min(bitCount, 32U);
+			value = 0U;
+		}
+		if (bitCount > 0U) {
+			Ar.SerializeBits(&value, bitCount);
+		}
+	}
+}
+
+uint32 FResourceReplicatedState::QuantizeAmount(float amount) {
+	return static_cast<uint32>(FMath::Clamp<int64>(FMath::RoundToInt64(static_cast<double>(amount) * AmountSteps), 0, MAX_uint32));
+}
+float FResourceReplicatedState::DequantizeAmount(uint32 value) {
+	return static_cast<float>(value / static_cast<double>(AmountSteps));
+}
+uint32 FResourceReplicatedState::QuantizeTime(float time) {
+	return static_cast<uint32>(FMath::Clamp<int64>(FMath::RoundToInt64(static_cast<double>(time) * 1000.0), 0, MAX_uint32));
+}
+float FResourceReplicatedState::DequantizeTime(uint32 value) {
+	return static_cast<float>(value / 1000.0);
+}
+bool FResourceReplicatedState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+	uint32 amount = Ar.IsSaving() ? QuantizeAmount(Amount) : 0U;
+	uint32 drainTime = Ar.IsSaving() ? QuantizeTime(TimeAtLastDrain) : 0U;
+	SerializePackedBits(Ar, amount);
+	SerializePackedBits(Ar, drainTime);
+	if (Ar.IsLoading()) {
+		Amount = DequantizeAmount(amount);
+		TimeAtLastDrain = DequantizeTime(drainTime);
+	}
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+static_assert(RS_MAX <= 1 << FResourceStatModifier::StatBits, "Every stat must fit in StatBits.");
+static_assert(RSO_Override < 1 << FResourceStatModifier::OperationBits, "Every operation must fit in OperationBits.");
+bool FResourceStatModifier::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+	uint8 stat = Stat;
+	uint8 operation = Operation;
+	Ar.SerializeBits(&stat, StatBits);
+	Ar.SerializeBits(&operation, OperationBits);
+	Ar << Magnitude;
+	if (Ar.IsLoading()) {
+		Stat = static_cast<EResourceStat>(stat);
+		Operation = static_cast<EResourceStatOperation>(operation);
+		Id = 0;
+		Source = NAME_None;
+	}
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
 
 void UResourceComponentBase::K2_AddResource_Implementation(float addAmount) {
 	AddResource(addAmount);
@@ -38,24 +117,151 @@ bool UResourceComponentBase::K2_GetCanBeDrained_Implementation() const {
 	return GetCanBeDrained();
 }
 float UResourceComponentBase::GetTimeSinceLastDrain_Implementation() const {
-	return GetWorld()->GetTimeSeconds() - TimeAtLastDrain;
+	return GetWorld()->GetTimeSeconds() - State.TimeAtLastDrain;
 }
 
 UResourceComponentBase::UResourceComponentBase() {
 	PrimaryComponentTick.bCanEverTick = false;
 	SetIsReplicatedByDefault(true);
-
+	for (float& base : StatCacheBase) {
+		base = std::numeric_limits<float>::quiet_NaN();
+	}
+}
+void UResourceComponentBase::PostInitProperties() {
+	Super::PostInitProperties();
+	bMaxAmountOverriddenInScript = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UResourceComponentBase, K2_GetMaxAmount));
 }
 void UResourceComponentBase::BeginPlay() {
 	Super::BeginPlay();
+	ApplyArchetype();
 	if(GetOwner()->HasAuthority()) {
-		CurrentAmount = bRegenBeginsEmpty ? 0.f : K2_GetMaxAmount();
+		State.Amount = bRegenBeginsEmpty ? 0.f : GetEffectiveMaxAmount();
+		if (bUseWorldStore) {
+			WorldStore = UResourceWorldStore::Get(this);
+		}
+		if (WorldStore) {
+			WorldStoreHandle = WorldStore->Register(this, State.Amount, GetEffectiveMaxAmount(), GetRegenParams());
+			if (State.Amount < GetEffectiveMaxAmount()) {
+				WorldStore->ScheduleRegen(WorldStoreHandle, -1.f);
+			}
+		}
+		if (bUseSimulationLOD) {
+			if (UResourceSimulationLOD* simulationLOD = UResourceSimulationLOD::Get(this)) {
+				simulationLOD->Register(this);
+			}
+		}
+		ApplyReplicationPolicy();
+	}
+	else {
+		ApplyReplicatedPercent(false);
 	}
 }
+void UResourceComponentBase::ApplyArchetype() {
+	if (!IsValid(Archetype)) {
+		return;
+	}
+	MaxAmount = Archetype->MaxAmount;
+	bRegenBeginsEmpty = Archetype->bRegenBeginsEmpty;
+	RegenAmount = Archetype->RegenAmount;
+	RegenRate = Archetype->RegenRate;
+	RegenDelay = Archetype->RegenDelay;
+	AdditionalExhaustedDelay = Archetype->AdditionalExhaustedDelay;
+	bRegenAfterDepletion = Archetype->bRegenAfterDepletion;
+	for (const FResourceArchetypeOverride& archetypeOverride : ArchetypeOverrides) {
+		switch (archetypeOverride.Stat) {
+		case RS_MaxAmount:
+			MaxAmount = archetypeOverride.Value;
+			break;
+		case RS_RegenAmount:
+			RegenAmount = archetypeOverride.Value;
+			break;
+		case RS_RegenRate:
+			RegenRate = archetypeOverride.Value;
+			break;
+		case RS_RegenDelay:
+			RegenDelay = archetypeOverride.Value;
+			break;
+		default:
+			break;
+		}
+	}
+}
+void UResourceComponentBase::ImportState(const ResourceCore::FResourceState& state) {
+	if (!GetOwner()->HasAuthority() || !HasBegunPlay()) {
+		return;
+	}
+	const float oldAmount = State.Amount;
+	State.Amount = FMath::Min(state.Current, GetEffectiveMaxAmount());
+	State.TimeAtLastDrain = static_cast<float>(state.TimeAtLastDrain);
+	bDrainDisabled = state.bDrainDisabled;
+	if (oldAmount != State.Amount) {
+		SendResourceChange(oldAmount, State.Amount);
+	}
+	// The imported schedule replaces whatever this component had scheduled.
+	const bool bRegenScheduled = state.NextRegenTime >= 0 && ShouldRegen();
+	if (IsUsingWorldStore()) {
+		SyncWorldStore();
+		WorldStore->SetSchedule(WorldStoreHandle, state.TimeAtLastDrain, bRegenScheduled ? state.NextRegenTime : -1.0, state.bFirstRegenTick);
+	}
+	else if (bRegenScheduled) {
+		SetRegenTimer(FMath::Max(0.f, static_cast<float>(state.NextRegenTime - GetWorld()->GetTimeSeconds())));
+		bFirstRegenTick = state.bFirstRegenTick;
+	}
+	else {
+		StopRegenTimer();
+	}
+}
+void UResourceComponentBase::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	GetWorld()->GetTimerManager().ClearTimer(PercentSendTimer);
+	if (bUseSimulationLOD) {
+		if (UResourceSimulationLOD* simulationLOD = UResourceSimulationLOD::Get(this)) {
+			simulationLOD->Unregister(this);
+		}
+	}
+	if (WorldStore) {
+		WorldStore->Unregister(WorldStoreHandle);
+		WorldStore = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
 void UResourceComponentBase::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(UResourceComponentBase, CurrentAmount);
-	DOREPLIFETIME(UResourceComponentBase, TimeAtLastDrain);
+	// Conditions are set per component by ApplyReplicationPolicy.
+	FDoRepLifetimeParams params;
+	params.Condition = COND_Dynamic;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UResourceComponentBase, State, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UResourceComponentBase, StatModifiers, params);
+	// Only changes under RRP_OwnerFullOthersPercent, so it costs nothing under the other policies.
+	DOREPLIFETIME_CONDITION(UResourceComponentBase, ReplicatedPercent, COND_SkipOwner);
+	DOREPLIFETIME(UResourceComponentBase, ReplicationPolicy);
+}
+void UResourceComponentBase::SetReplicationPolicy(EResourceReplicationPolicy newPolicy) {
+	if (newPolicy == ReplicationPolicy || !GetOwner() || !GetOwner()->HasAuthority()) {
+		return;
+	}
+	ReplicationPolicy = newPolicy;
+	if (HasBegunPlay()) {
+		ApplyReplicationPolicy();
+	}
+}
+void UResourceComponentBase::ApplyReplicationPolicy() {
+	switch (ReplicationPolicy) {
+	case RRP_OwnerFullOthersPercent:
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, State, COND_OwnerOnly);
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, StatModifiers, COND_OwnerOnly);
+		GetWorld()->GetTimerManager().ClearTimer(PercentSendTimer);
+		ReplicatedPercent = QuantizePercent(GetCurrentPercent());
+		LastPercentSendTime = GetWorld()->GetTimeSeconds();
+		break;
+	case RRP_OwnerOnly:
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, State, COND_OwnerOnly);
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, StatModifiers, COND_OwnerOnly);
+		break;
+	default:
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, State, COND_None);
+		DOREPDYNAMICCONDITION_SETCONDITION_FAST(UResourceComponentBase, StatModifiers, COND_None);
+		break;
+	}
 }
 
 void UResourceComponentBase::AddResource(float addAmount) {
@@ -63,25 +269,36 @@ void UResourceComponentBase::AddResource(float addAmount) {
 		K2_DrainResource(addAmount * -1);
 		return;
 	}
-	if (CurrentAmount >= K2_GetMaxAmount()) {
+	AdvanceLODRegen();
+	if (IsUsingWorldStore()) {
+		ApplyWorldStoreEvents(State.Amount, WorldStore->Add(WorldStoreHandle, addAmount));
 		return;
 	}
-	float initialAmount = CurrentAmount;
-	float predictedAmount = FMath::Min(CurrentAmount + addAmount, K2_GetMaxAmount());
-	
-	CurrentAmount = FMath::Min(K2_GetMaxAmount(), CurrentAmount + addAmount);
-	BroadcastResourceChange_Net(initialAmount, predictedAmount);
+	const float maxAmount = GetEffectiveMaxAmount();
+	if (State.Amount >= maxAmount) {
+		return;
+	}
+	const ResourceCore::FAmountChange change = ResourceCore::ApplyAdd(State.Amount, addAmount, maxAmount);
 	
+	State.Amount = change.NewValue;
+	SendResourceChange(change.OldValue, change.NewValue);
+
+	if (SimulationLOD != RSL_Full) {
+		if (State.Amount >= maxAmount) {
+			StopRegenTimer();
+		}
+		return;
+	}
 	bool timerActive = !GetWorld()->GetTimerManager().IsTimerPending(RegenTimer);
 	if (timerActive) {
-		BroadcastRegenEvent_Net(EHealthRegenEventType::Tick);
+		SendRegenEvent(EHealthRegenEventType::Tick);
 		if (bFirstRegenTick) {
 			bFirstRegenTick = false;
-			BroadcastRegenEvent_Net(EHealthRegenEventType::Start);
+			SendRegenEvent(EHealthRegenEventType::Start);
 		}
-		if (GetCurrentPercent() >= 1) {
+		if (State.Amount >= maxAmount) {
 			StopRegenTimer();
-			BroadcastRegenEvent_Net(EHealthRegenEventType::End);
+			SendRegenEvent(EHealthRegenEventType::End);
 		}
 	}
 }
@@ -93,21 +310,26 @@ void UResourceComponentBase::DrainResource(float drainAmount) {
 	if (bDrainDisabled) {
 		return;
 	}
-	float initialAmount = CurrentAmount;
-	float predictedAmount = FMath::Max(0.f, CurrentAmount - drainAmount);
+	AdvanceLODRegen();
+	if (IsUsingWorldStore()) {
+		State.TimeAtLastDrain = GetWorld()->GetTimeSeconds();
+		ApplyWorldStoreEvents(State.Amount, WorldStore->Drain(WorldStoreHandle, drainAmount));
+		return;
+	}
+	const ResourceCore::FAmountChange change = ResourceCore::ApplyDrain(State.Amount, drainAmount);
 	
-	CurrentAmount = FMath::Max(predictedAmount, 0);
-	BroadcastResourceChange_Net(initialAmount, predictedAmount);
+	State.Amount = change.NewValue;
+	SendResourceChange(change.OldValue, change.NewValue);
 
 	/* Drain time registration */ {
 		float gameTime = GetWorld()->GetTimeSeconds();
-		TimeAtLastDrain = gameTime;
+		State.TimeAtLastDrain = gameTime;
 	}
 
 	/* Regen timer */ {
 		bool timerActive = !GetWorld()->GetTimerManager().IsTimerPending(RegenTimer);
-		if (timerActive) {
-			BroadcastRegenEvent_Net(EHealthRegenEventType::End);
+		if (timerActive && SimulationLOD == RSL_Full) {
+			SendRegenEvent(EHealthRegenEventType::End);
 		}
 		SetRegenTimer();
 	}
@@ -115,28 +337,29 @@ void UResourceComponentBase::DrainResource(float drainAmount) {
 void UResourceComponentBase::AddResourceByPercent(float addPercent, EResourcePercentType percentType) {
 	float fillValue = 0.f;
 	if (percentType == EResourcePercentType::Current) {
-		fillValue = CurrentAmount * addPercent;
+		fillValue = State.Amount * addPercent;
 	}
 	else {
-		fillValue = K2_GetMaxAmount() * addPercent;
+		fillValue = GetEffectiveMaxAmount() * addPercent;
 	}
 	K2_AddResource(fillValue);
 }
 void UResourceComponentBase::DrainResourceByPercent(float drainPercent, EResourcePercentType percentType) {
 	float drainValue = 0.f;
 	if (percentType == EResourcePercentType::Current) {
-		drainValue = CurrentAmount * drainPercent;
+		drainValue = State.Amount * drainPercent;
 	}
 	else {
-		drainValue = K2_GetMaxAmount() * drainPercent;
+		drainValue = GetEffectiveMaxAmount() * drainPercent;
 	}
 	K2_DrainResource(drainValue);
 }
 
 void UResourceComponentBase::SetRegenAmount(float newRegenAmount) {
+	AdvanceLODRegen();
 	float timerRemaining = GetRegenDelay();
-	if (RegenTimer.IsValid()) {
-		timerRemaining = GetWorld()->GetTimerManager().GetTimerRemaining(RegenTimer);
+	if (RegenTimer.IsValid() || PendingRegenTime >= 0) {
+		timerRemaining = GetRegenTimeRemaining();
 	}
 	RegenAmount = newRegenAmount;
 	if (timerRemaining > 0) {
@@ -147,9 +370,10 @@ void UResourceComponentBase::SetRegenAmount(float newRegenAmount) {
 	}
 }
 void UResourceComponentBase::SetRegenRate(float newRegenRate) {
+	AdvanceLODRegen();
 	float timerRemaining = GetRegenDelay();
-	if (RegenTimer.IsValid()) {
-		timerRemaining = GetWorld()->GetTimerManager().GetTimerRemaining(RegenTimer);
+	if (RegenTimer.IsValid() || PendingRegenTime >= 0) {
+		timerRemaining = GetRegenTimeRemaining();
 	}
 	RegenRate = newRegenRate;
 	if (timerRemaining > 0) {
@@ -160,9 +384,10 @@ void UResourceComponentBase::SetRegenRate(float newRegenRate) {
 	}
 }
 void UResourceComponentBase::SetRegenDelay(float newRegenDelay) {
+	AdvanceLODRegen();
 	float timerRemaining = 0.f;
-	if (RegenTimer.IsValid()) {
-		timerRemaining = GetWorld()->GetTimerManager().GetTimerRemaining(RegenTimer);
+	if (RegenTimer.IsValid() || PendingRegenTime >= 0) {
+		timerRemaining = GetRegenTimeRemaining();
 	}
 	RegenDelay = newRegenDelay;
 	if (timerRemaining > 0) {
@@ -173,19 +398,43 @@ void UResourceComponentBase::SetRegenDelay(float newRegenDelay) {
 	}
 }
 bool UResourceComponentBase::ShouldRegen() const {
-	if ((RegenAmount <= 0) || (RegenRate <= 0) || (GetRegenDelay() < 0)) {
-		return false;
-	}
-	return true;
+	return ResourceCore::ShouldRegen(State.Amount, GetRegenParams());
+}
+ResourceCore::FRegenParams UResourceComponentBase::GetRegenParams() const {
+	ResourceCore::FRegenParams params;
+	params.Amount = GetStat(RS_RegenAmount, RegenAmount);
+	params.Rate = GetStat(RS_RegenRate, RegenRate);
+	params.Delay = GetStat(RS_RegenDelay, RegenDelay);
+	params.AdditionalExhaustedDelay = AdditionalExhaustedDelay;
+	params.bRegenAfterDepletion = bRegenAfterDepletion;
+	return params;
 }
 void UResourceComponentBase::SetRegenTimer(float initialDelay) {
+	if (IsUsingWorldStore()) {
+		SyncWorldStore();
+		WorldStore->ScheduleRegen(WorldStoreHandle, initialDelay);
+		return;
+	}
+	if (SimulationLOD != RSL_Full) {
+		PendingRegenTime = -1.0;
+		if (ShouldRegen()) {
+			if (initialDelay < 0) {
+				bFirstRegenTick = true;
+				initialDelay = GetRegenDelay();
+			}
+			PendingRegenTime = GetWorld()->GetTimeSeconds() + initialDelay;
+		}
+		UpdateLODRegenTimer();
+		return;
+	}
 	StopRegenTimer();
 	if (!ShouldRegen()) {
 		return;
 	}
 
+	const ResourceCore::FRegenParams params = GetRegenParams();
 	FTimerDelegate timerDel;
-	timerDel.BindUObject(this, &UResourceComponentBase::K2_AddResource, RegenAmount);
+	timerDel.BindUObject(this, &UResourceComponentBase::K2_AddResource, params.Amount);
 
 	FTimerManagerTimerParameters timerParams;
 	if (initialDelay >= 0) {
@@ -197,50 +446,474 @@ void UResourceComponentBase::SetRegenTimer(float initialDelay) {
 	}
 	timerParams.bLoop = true;
 
-	GetWorld()->GetTimerManager().SetTimer(RegenTimer, timerDel, 1 / RegenRate, timerParams);
+	GetWorld()->GetTimerManager().SetTimer(RegenTimer, timerDel, 1 / params.Rate, timerParams);
+}
+
+void UResourceComponentBase::SetSimulationLOD(EResourceSimulationLOD newLOD) {
+	const EResourceSimulationLOD oldLOD = SimulationLOD;
+	if (newLOD == oldLOD || !GetOwner() || !GetOwner()->HasAuthority()) {
+		return;
+	}
+	if (!HasBegunPlay() || IsUsingWorldStore()) {
+		SimulationLOD = newLOD;
+		OnSimulationLODChanged(oldLOD);
+		return;
+	}
+	FTimerManager& timerManager = GetWorld()->GetTimerManager();
+	if (oldLOD == RSL_Full) {
+		// The next tick the regen timer would have applied becomes the pending regen time.
+		PendingRegenTime = timerManager.IsTimerActive(RegenTimer) ? GetWorld()->GetTimeSeconds() + timerManager.GetTimerRemaining(RegenTimer) : -1.0;
+		timerManager.ClearTimer(RegenTimer);
+		RegenTimer.Invalidate();
+		SimulationLOD = newLOD;
+		UpdateLODRegenTimer();
+	}
+	else {
+		// Catch up at the old LOD, then carry the schedule over.
+		AdvanceLODRegen();
+		SimulationLOD = newLOD;
+		if (newLOD == RSL_Full) {
+			const double nextRegenTime = PendingRegenTime;
+			const bool bWasFirstRegenTick = bFirstRegenTick;
+			StopRegenTimer();
+			if (nextRegenTime >= 0 && ShouldRegen()) {
+				SetRegenTimer(FMath::Max(0.f, static_cast<float>(nextRegenTime - GetWorld()->GetTimeSeconds())));
+				bFirstRegenTick = bWasFirstRegenTick;
+			}
+		}
+		else {
+			UpdateLODRegenTimer();
+		}
+	}
+	OnSimulationLODChanged(oldLOD);
+}
+void UResourceComponentBase::AdvanceLODRegen() {
+	if (SimulationLOD == RSL_Full || PendingRegenTime < 0) {
+		return;
+	}
+	const double now = GetWorld()->GetTimeSeconds();
+	if (now < PendingRegenTime) {
+		return;
+	}
+	ResourceCore::FResourceState state;
+	state.Current = State.Amount;
+	state.Max = GetEffectiveMaxAmount();
+	state.TimeAtLastDrain = State.TimeAtLastDrain;
+	state.NextRegenTime = PendingRegenTime;
+	state.bFirstRegenTick = bFirstRegenTick;
+	state.bDrainDisabled = bDrainDisabled;
+	// Regen start, tick and end are cosmetic and not sent below Full. The amount change is sent once per catch-up.
+	ResourceCore::AdvanceRegen(state, now, GetRegenParams());
+	const float oldAmount = State.Amount;
+	State.Amount = state.Current;
+	PendingRegenTime = state.NextRegenTime;
+	bFirstRegenTick = state.bFirstRegenTick;
+	if (oldAmount != State.Amount) {
+		SendResourceChange(oldAmount, State.Amount);
+	}
+	UpdateLODRegenTimer();
+}
+void UResourceComponentBase::UpdateLODRegenTimer() {
+	FTimerManager& timerManager = GetWorld()->GetTimerManager();
+	if (SimulationLOD == RSL_Reduced && PendingRegenTime >= 0) {
+		if (!timerManager.IsTimerActive(RegenTimer)) {
+			const float firstDelay = FMath::Max(0.f, static_cast<float>(PendingRegenTime - GetWorld()->GetTimeSeconds()));
+			timerManager.SetTimer(RegenTimer, this, &UResourceComponentBase::AdvanceLODRegen, UResourceSimulationLOD::GetReducedRegenInterval(), true, firstDelay);
+		}
+		return;
+	}
+	timerManager.ClearTimer(RegenTimer);
+	RegenTimer.Invalidate();
+}
+float UResourceComponentBase::GetRegenTimeRemaining() const {
+	if (SimulationLOD != RSL_Full && !IsUsingWorldStore()) {
+		return PendingRegenTime >= 0 ? FMath::Max(0.f, static_cast<float>(PendingRegenTime - GetWorld()->GetTimeSeconds())) : -1.f;
+	}
+	return GetWorld()->GetTimerManager().GetTimerRemaining(RegenTimer);
 }
 
+int32 UResourceComponentBase::AddStatModifier(EResourceStat stat, EResourceStatOperation operation, float magnitude, FName source) {
+	if (stat >= RS_MAX) {
+		return 0;
+	}
+	FResourceStatModifier& modifier = StatModifiers.AddDefaulted_GetRef();
+	modifier.Id = ++NextStatModifierId;
+	modifier.Source = source;
+	modifier.Stat = stat;
+	modifier.Operation = operation;
+	modifier.Magnitude = magnitude;
+	const int32 id = modifier.Id;
+	OnStatModifiersChanged();
+	return id;
+}
+bool UResourceComponentBase::RemoveStatModifier(int32 modifierId) {
+	if (StatModifiers.RemoveAll([modifierId](const FResourceStatModifier& m) { return m.Id == modifierId; }) == 0) {
+		return false;
+	}
+	OnStatModifiersChanged();
+	return true;
+}
+int32 UResourceComponentBase::RemoveStatModifiersFromSource(FName source) {
+	const int32 removed = StatModifiers.RemoveAll([source](const FResourceStatModifier& m) { return m.Source == source; });
+	if (removed > 0) {
+		OnStatModifiersChanged();
+	}
+	return removed;
+}
+float UResourceComponentBase::GetStatValue(EResourceStat stat) const {
+	switch (stat) {
+	case RS_MaxAmount:
+		return GetEffectiveMaxAmount();
+	case RS_RegenAmount:
+		return GetStat(RS_RegenAmount, RegenAmount);
+	case RS_RegenRate:
+		return GetStat(RS_RegenRate, RegenRate);
+	case RS_RegenDelay:
+		return GetStat(RS_RegenDelay, RegenDelay);
+	default:
+		return 0.f;
+	}
+}
+float UResourceComponentBase::AggregateStat(EResourceStat stat, float base) const {
+	TArray<ResourceCore::FStatModifier, TInlineAllocator<8>> modifiers;
+	for (const FResourceStatModifier& modifier : StatModifiers) {
+		if (modifier.Stat == stat) {
+			modifiers.Add({ static_cast<ResourceCore::EStatOperation>(modifier.Operation.GetValue()), modifier.Magnitude });
+		}
+	}
+	StatCacheBase[stat] = base;
+	StatCacheValue[stat] = ResourceCore::AggregateStat(base, modifiers.GetData(), modifiers.Num());
+	return StatCacheValue[stat];
+}
+void UResourceComponentBase::OnRep_StatModifiers() {
+	OnStatModifiersChanged();
+}
+void UResourceComponentBase::OnStatModifiersChanged() {
+	for (float& base : StatCacheBase) {
+		base = std::numeric_limits<float>::quiet_NaN();
+	}
+	if (!GetOwner() || !GetOwner()->HasAuthority() || !HasBegunPlay()) {
+		return;
+	}
+	// Ticks due before the change use the old values.
+	AdvanceLODRegen();
+	const float maxAmount = GetEffectiveMaxAmount();
+	if (State.Amount > maxAmount) {
+		const float oldAmount = State.Amount;
+		State.Amount = maxAmount;
+		SendResourceChange(oldAmount, State.Amount);
+	}
+	if (IsUsingWorldStore()) {
+		SyncWorldStore();
+		WorldStore->ScheduleRegen(WorldStoreHandle, GetRegenDelay());
+		return;
+	}
+	// Re-time regen with the new values, keeping whatever delay is left, like Set Regen Rate.
+	FTimerManager& timerManager = GetWorld()->GetTimerManager();
+	if (SimulationLOD != RSL_Full ? PendingRegenTime >= 0 : timerManager.IsTimerActive(RegenTimer)) {
+		const float timerRemaining = GetRegenTimeRemaining();
+		SetRegenTimer(timerRemaining > 0 ? timerRemaining : -1.f);
+	}
+	else if (State.Amount < maxAmount) {
+		// e.g. the max amount grew while full.
+		SetRegenTimer();
+	}
+}
+bool UResourceComponentBase::RegisterDrainTime_Server_Validate(float time) {
+	return FMath::IsFinite(time) && time >= 0;
+}
 void UResourceComponentBase::RegisterDrainTime_Server_Implementation(float time) {
-	TimeAtLastDrain = time;
+	if (UResourceRPCIntake* intake = UResourceRPCIntake::Get(this)) {
+		intake->SubmitDrainTime(this, time);
+	}
+}
+bool UResourceComponentBase::AddResource_Server_Validate(float additional) {
+	return FMath::IsFinite(additional);
 }
 void UResourceComponentBase::AddResource_Server_Implementation(float additional) {
-	float initialAmount = CurrentAmount;
-	CurrentAmount = FMath::Min(K2_GetMaxAmount(), CurrentAmount + additional);
-	BroadcastResourceChange_Net(initialAmount, CurrentAmount);
+	if (UResourceRPCIntake* intake = UResourceRPCIntake::Get(this)) {
+		intake->SubmitAmount(this, additional);
+	}
+}
+bool UResourceComponentBase::DrainResource_Server_Validate(float removal) {
+	return FMath::IsFinite(removal);
 }
 void UResourceComponentBase::DrainResource_Server_Implementation(float removal) {
-	float initialAmount = CurrentAmount;
-	CurrentAmount = FMath::Max(CurrentAmount - removal, 0);
-	BroadcastResourceChange_Net(initialAmount, CurrentAmount);
+	if (UResourceRPCIntake* intake = UResourceRPCIntake::Get(this)) {
+		intake->SubmitAmount(this, -removal);
+	}
+}
+void UResourceComponentBase::ApplyIntakeRequests(const FResourceIntakeRequests& requests) {
+	if (requests.bHasDrainTime) {
+		State.TimeAtLastDrain = requests.DrainTime;
+	}
+	// Through the regular paths, so regen, the simulation LOD and the world store are handled as for any add or drain.
+	for (const float amount : requests.AmountSteps) {
+		if (amount >= 0) {
+			AddResource(amount);
+		}
+		else {
+			DrainResource(-amount);
+		}
+	}
+}
+void UResourceComponentBase::SyncWorldStore() {
+	if (IsUsingWorldStore()) {
+		WorldStore->SetValues(WorldStoreHandle, State.Amount, GetEffectiveMaxAmount(), GetRegenParams());
+	}
+}
+void UResourceComponentBase::ApplyWorldStoreEvents(float oldValue, uint32 events) {
+	State.Amount = WorldStore->GetCurrentAmount(WorldStoreHandle);
+	if (events & ResourceCore::Event_Changed) {
+		SendResourceChange(oldValue, State.Amount);
+	}
+	if (events & ResourceCore::Event_RegenStart) {
+		SendRegenEvent(EHealthRegenEventType::Start);
+	}
+	if (events & ResourceCore::Event_RegenTick) {
+		SendRegenEvent(EHealthRegenEventType::Tick);
+	}
+	if (events & ResourceCore::Event_RegenEnd) {
+		SendRegenEvent(EHealthRegenEventType::End);
+	}
 }
 
-void UResourceComponentBase::BroadcastResourceChange_Net_Implementation(float oldValue, float newValue) {
-	if (oldValue != newValue) {
-		OnCurrentAmountChange.Broadcast(newValue);
+void UResourceComponentBase::SendResourceChange(float oldValue, float newValue) {
+	if (ReplicationPolicy == RRP_Everyone) {
+		BroadcastResourceChange_Net(oldValue, newValue);
+		return;
 	}
-	if (oldValue > newValue) {
-		OnDrain.Broadcast(newValue);
+	ReceiveResourceChange(oldValue, newValue);
+	if (HasRemoteOwner()) {
+		BroadcastResourceChange_Owner(oldValue, newValue);
 	}
-	if (newValue > oldValue) {
-		OnAdd.Broadcast(newValue);
+	if (ReplicationPolicy == RRP_OwnerFullOthersPercent) {
+		UpdateReplicatedPercent();
 	}
-	if (newValue != oldValue && newValue == 0) {
-		OnEmpty.Broadcast();
+}
+void UResourceComponentBase::SendRegenEvent(EHealthRegenEventType type, float newValue) {
+	if (ReplicationPolicy == RRP_Everyone) {
+		BroadcastRegenEvent_Net(type, newValue);
+		return;
 	}
-	if (newValue != oldValue && newValue == GetMaxAmount()) {
-		OnFill.Broadcast();
+	ReceiveRegenEvent(type, newValue);
+	if (HasRemoteOwner()) {
+		BroadcastRegenEvent_Owner(type, newValue);
+	}
+}
+bool UResourceComponentBase::HasRemoteOwner() const {
+	const AActor* owner = GetOwner();
+	return IsValid(owner) && owner->GetNetConnection() != nullptr;
+}
+uint8 UResourceComponentBase::QuantizePercent(float percent) {
+	if (percent <= 0) {
+		return 0;
+	}
+	if (percent >= 1) {
+		return 255;
+	}
+	return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(percent * 255.f), 1, 254));
+}
+void UResourceComponentBase::UpdateReplicatedPercent() {
+	const uint8 percent = QuantizePercent(GetCurrentPercent());
+	if (percent == ReplicatedPercent) {
+		return;
+	}
+	FTimerManager& timerManager = GetWorld()->GetTimerManager();
+	const double now = GetWorld()->GetTimeSeconds();
+	const float interval = percent == 0 || percent == 255 ? 0.f : GetPercentSendInterval();
+	const float remaining = static_cast<float>(LastPercentSendTime + interval - now);
+	if (remaining <= 0) {
+		timerManager.ClearTimer(PercentSendTimer);
+		ReplicatedPercent = percent;
+		LastPercentSendTime = now;
+	}
+	else if (!timerManager.IsTimerActive(PercentSendTimer)) {
+		timerManager.SetTimer(PercentSendTimer, this, &UResourceComponentBase::UpdateReplicatedPercent, remaining, false);
+	}
+}
+float UResourceComponentBase::GetPercentSendInterval() const {
+	const float maxInterval = CVarReplicationPercentMaxInterval.GetValueOnGameThread();
+	const AActor* owner = GetOwner();
+	if (maxInterval <= 0 || !IsValid(owner)) {
+		return 0.f;
+	}
+	const FVector location = owner->GetActorLocation();
+	float nearestDistanceSquared = TNumericLimits<float>::Max();
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it) {
+		const APlayerController* playerController = it->Get();
+		if (!playerController || owner->IsOwnedBy(playerController)) {
+			continue;
+		}
+		FVector viewLocation;
+		FRotator viewRotation;
+		playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+		nearestDistanceSquared = FMath::Min(nearestDistanceSquared, static_cast<float>(FVector::DistSquared(viewLocation, location)));
 	}
+	const float nearDistance = CVarReplicationPercentNearDistance.GetValueOnGameThread();
+	const float farDistance = FMath::Max(nearDistance + 1.f, CVarReplicationPercentFarDistance.GetValueOnGameThread());
+	const float alpha = FMath::Clamp((FMath::Sqrt(nearestDistanceSquared) - nearDistance) / (farDistance - nearDistance), 0.f, 1.f);
+	return maxInterval * alpha;
+}
+void UResourceComponentBase::OnRep_ReplicatedPercent() {
+	// Before BeginPlay the archetype is not applied yet. BeginPlay applies the percent instead.
+	if (HasBegunPlay()) {
+		ApplyReplicatedPercent(true);
+	}
+}
+void UResourceComponentBase::ApplyReplicatedPercent(bool bBroadcast) {
+	// A percent left over from an earlier policy is ignored. ReplicationPolicy is applied before any rep notify runs.
+	if (ReplicationPolicy != RRP_OwnerFullOthersPercent || GetOwner()->HasLocalNetOwner()) {
+		return;
+	}
+	const float oldAmount = State.Amount;
+	const float maxAmount = GetEffectiveMaxAmount();
+	State.Amount = ReplicatedPercent == 255 ? maxAmount : maxAmount * ReplicatedPercent / 255.f;
+	if (bBroadcast && oldAmount != State.Amount) {
+		ReceiveResourceChange(oldAmount, State.Amount);
+	}
+}
+
+void UResourceComponentBase::BroadcastResourceChange_Net_Implementation(float oldValue, float newValue) {
+	RESOURCE_NET_STAT_RPC(this, "BroadcastResourceChange_Net");
+	ReceiveResourceChange(oldValue, newValue);
 }
 void UResourceComponentBase::BroadcastRegenEvent_Net_Implementation(EHealthRegenEventType type, float newValue) {
+	RESOURCE_NET_STAT_RPC(this, "BroadcastRegenEvent_Net");
+	ReceiveRegenEvent(type, newValue);
+}
+void UResourceComponentBase::BroadcastResourceChange_Owner_Implementation(float oldValue, float newValue) {
+	RESOURCE_NET_STAT_RPC(this, "BroadcastResourceChange_Owner");
+	ReceiveResourceChange(oldValue, newValue);
+}
+void UResourceComponentBase::BroadcastRegenEvent_Owner_Implementation(EHealthRegenEventType type, float newValue) {
+	RESOURCE_NET_STAT_RPC(this, "BroadcastRegenEvent_Owner");
+	ReceiveRegenEvent(type, newValue);
+}
+void UResourceComponentBase::ReceiveResourceChange(float oldValue, float newValue) {
+	DispatchEvents(ResourceCore::GetChangeEvents({ oldValue, newValue }, GetEffectiveMaxAmount()), newValue);
+	EvaluateThresholds(oldValue, newValue);
+}
+void UResourceComponentBase::ReceiveRegenEvent(EHealthRegenEventType type, float newValue) {
 	switch (type) {
 	case EHealthRegenEventType::Start:
-		OnRegenStart.Broadcast();
+		DispatchEvents(ResourceCore::Event_RegenStart, newValue);
 		break;
 	case EHealthRegenEventType::Tick:
-		OnRegenTick.Broadcast(newValue);
+		DispatchEvents(ResourceCore::Event_RegenTick, newValue);
 		break;
 	case EHealthRegenEventType::End:
+		DispatchEvents(ResourceCore::Event_RegenEnd, newValue);
+		break;
+	}
+}
+void UResourceComponentBase::DispatchEvents(uint32 events, float value) {
+	if (events == ResourceCore::Event_None) {
+		return;
+	}
+	if (bBatchEvents) {
+		if (UResourceEventSubsystem* eventSubsystem = UResourceEventSubsystem::Get(this)) {
+			eventSubsystem->QueueEvents(this, events, value);
+			return;
+		}
+	}
+	ForEachEventType(events, [this, value](EResourceEventType type) {
+		BroadcastEvent(type, value);
+	});
+}
+int32 UResourceComponentBase::AddThreshold(float value, bool bPercent, EResourceThresholdDirection direction, float hysteresis) {
+	ResourceCore::FThreshold threshold;
+	threshold.Value = value;
+	threshold.Hysteresis = hysteresis;
+	threshold.Id = ++NextThresholdId;
+	switch (direction) {
+	case RTD_Falling:
+		threshold.Direction = ResourceCore::EThresholdDirection::Falling;
+		break;
+	case RTD_Rising:
+		threshold.Direction = ResourceCore::EThresholdDirection::Rising;
+		break;
+	default:
+		threshold.Direction = ResourceCore::EThresholdDirection::Both;
+		break;
+	}
+	if (bPercent) {
+		ResourceCore::AddThreshold(PercentThresholds, threshold, GetCurrentPercent());
+	}
+	else {
+		ResourceCore::AddThreshold(AmountThresholds, threshold, State.Amount);
+	}
+	return threshold.Id;
+}
+bool UResourceComponentBase::RemoveThreshold(int32 thresholdId) {
+	return ResourceCore::RemoveThreshold(AmountThresholds, thresholdId) || ResourceCore::RemoveThreshold(PercentThresholds, thresholdId);
+}
+void UResourceComponentBase::EvaluateThresholds(float oldValue, float newValue) {
+	if (AmountThresholds.Thresholds.empty() && PercentThresholds.Thresholds.empty()) {
+		return;
+	}
+	// Only allocates when something was crossed.
+	std::vector<ResourceCore::FThresholdCrossing> crossings;
+	ResourceCore::EvaluateThresholds(AmountThresholds, oldValue, newValue, crossings);
+	if (!PercentThresholds.Thresholds.empty()) {
+		const float maxAmount = GetEffectiveMaxAmount();
+		ResourceCore::EvaluateThresholds(PercentThresholds, ResourceCore::GetPercent(oldValue, maxAmount), ResourceCore::GetPercent(newValue, maxAmount), crossings);
+	}
+	// Listeners may add or remove thresholds, so the crossings are collected before anything is broadcast.
+	for (const ResourceCore::FThresholdCrossing& crossing : crossings) {
+		if (OnThresholdCrossedNative.IsBound()) {
+			OnThresholdCrossedNative.Broadcast(crossing.Id, crossing.bRising, newValue);
+		}
+		OnThresholdCrossed.Broadcast(crossing.Id, crossing.bRising, newValue);
+	}
+}
+void UResourceComponentBase::BroadcastEvent(EResourceEventType type, float value) {
+	if (NativeEvents[type].IsBound()) {
+		NativeEvents[type].Broadcast(value);
+	}
+	switch (type) {
+	case RET_CurrentAmountChange:
+		OnCurrentAmountChange.Broadcast(value);
+		break;
+	case RET_Drain:
+		OnDrain.Broadcast(value);
+		break;
+	case RET_Add:
+		OnAdd.Broadcast(value);
+		break;
+	case RET_Empty:
+		OnEmpty.Broadcast();
+		break;
+	case RET_Fill:
+		OnFill.Broadcast();
+		break;
+	case RET_RegenStart:
+		OnRegenStart.Broadcast();
+		break;
+	case RET_RegenTick:
+		OnRegenTick.Broadcast(value);
+		break;
+	case RET_RegenEnd:
 		OnRegenEnd.Broadcast();
 		break;
 	}
 }
+void UResourceComponentBase::ForEachEventType(uint32 events, TFunctionRef<void(EResourceEventType)> func) {
+	// A fixed dispatch order, not the order the events happened in: a batched frame can hold events from several
+	// changes, e.g. a regen end followed by a drain that restarts regen. Regen start is always first and regen end last.
+	static const TPair<uint32, EResourceEventType> order[] = {
+		{ ResourceCore::Event_RegenStart, RET_RegenStart },
+		{ ResourceCore::Event_Changed, RET_CurrentAmountChange },
+		{ ResourceCore::Event_Drained, RET_Drain },
+		{ ResourceCore::Event_Added, RET_Add },
+		{ ResourceCore::Event_RegenTick, RET_RegenTick },
+		{ ResourceCore::Event_Emptied, RET_Empty },
+		{ ResourceCore::Event_Filled, RET_Fill },
+		{ ResourceCore::Event_RegenEnd, RET_RegenEnd }
+	};
+	for (const TPair<uint32, EResourceEventType>& entry : order) {
+		if (events & entry.Key) {
+			func(entry.Value);
+		}
+	}
+}
@@ -0,0 +1,235 @@
+// Copyright LyCH. 2024
+
+
+#include "Core/ResourceCore.h"
+#include "Core/ResourceCorePolicies.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ResourceCore {
+
+	FAmountChange ApplyAdd(float current, float addAmount, float maxAmount) {
+		return { current, std::min(maxAmount, current + addAmount) };
+	}
+	FAmountChange ApplyDrain(float current, float drainAmount) {
+		return { current, std::max(0.f, current - drainAmount) };
+	}
+	float GetPercent(float current, float maxAmount) {
+		return maxAmount > 0 ? current / maxAmount : 0.f;
+	}
+	uint32_t GetChangeEvents(const FAmountChange& change, float maxAmount) {
+		return FDefaultResourceCore::GetChangeEvents(change, maxAmount);
+	}
+
+	float GetRegenDelay(float current, const FRegenParams& params) {
+		return FDefaultResourceCore::GetRegenDelay(current, params);
+	}
+	bool ShouldRegen(float current, const FRegenParams& params) {
+		return FDefaultResourceCore::ShouldRegen(current, params);
+	}
+
+	uint32_t Add(FResourceState& state, float amount, double now, const FRegenParams& params) {
+		return FDefaultResourceCore::Add(state, amount, now, params);
+	}
+	uint32_t Drain(FResourceState& state, float amount, double now, const FRegenParams& params) {
+		return FDefaultResourceCore::Drain(state, amount, now, params);
+	}
+	uint32_t RestartRegen(FResourceState& state, double now, const FRegenParams& params) {
+		return FDefaultResourceCore::RestartRegen(state, now, params);
+	}
+	uint32_t AdvanceRegen(FResourceState& state, double now, const FRegenParams& params, int64_t* outTicks) {
+		return FDefaultResourceCore::AdvanceRegen(state, now, params, outTicks);
+	}
+
+	float AggregateStat(float base, const FStatModifier* modifiers, int32_t numModifiers) {
+		float flat = 0.f;
+		float percent = 0.f;
+		float multiplier = 1.f;
+		for (int32_t i = numModifiers - 1; i >= 0; i--) {
+			const FStatModifier& modifier = modifiers[i];
+			switch (modifier.Operation) {
+			case EStatOperation::Override:
+				return modifier.Magnitude;
+			case EStatOperation::Flat:
+				flat += modifier.Magnitude;
+				break;
+			case EStatOperation::PercentAdd:
+				percent += modifier.Magnitude;
+				break;
+			case EStatOperation::Multiply:
+				multiplier *= modifier.Magnitude;
+				break;
+			}
+		}
+		return (base + flat) * (1.f + percent) * multiplier;
+	}
+
+	void AddThreshold(FThresholdSet& set, FThreshold threshold, float currentValue) {
+		threshold.Hysteresis = std::max(0.f, threshold.Hysteresis);
+		threshold.bFallingArmed = currentValue >= threshold.Value + threshold.Hysteresis;
+		threshold.bRisingArmed = currentValue <= threshold.Value - threshold.Hysteresis;
+		const auto it = std::upper_bound(set.Thresholds.begin(), set.Thresholds.end(), threshold.Value,
+			[](float value, const FThreshold& t) { return value < t.Value; });
+		set.Thresholds.insert(it, threshold);
+		set.MaxHysteresis = std::max(set.MaxHysteresis, threshold.Hysteresis);
+	}
+	bool RemoveThreshold(FThresholdSet& set, int32_t id) {
+		const auto it = std::find_if(set.Thresholds.begin(), set.Thresholds.end(), [id](const FThreshold& t) { return t.Id == id; });
+		if (it == set.Thresholds.end()) {
+			return false;
+		}
+		set.Thresholds.erase(it);
+		set.MaxHysteresis = 0.f;
+		for (const FThreshold& t : set.Thresholds) {
+			set.MaxHysteresis = std::max(set.MaxHysteresis, t.Hysteresis);
+		}
+		return true;
+	}
+	void EvaluateThresholds(FThresholdSet& set, float oldValue, float newValue, std::vector<FThresholdCrossing>& outCrossings) {
+		if (oldValue == newValue || set.Thresholds.empty()) {
+			return;
+		}
+		const bool bRising = newValue > oldValue;
+		// Widened by the largest hysteresis so thresholds that only need re-arming are visited too.
+		const float low = std::min(oldValue, newValue) - set.MaxHysteresis;
+		const float high = std::max(oldValue, newValue) + set.MaxHysteresis;
+		const auto byValue = [](const FThreshold& t, float value) { return t.Value < value; };
+		const auto first = std::lower_bound(set.Thresholds.begin(), set.Thresholds.end(), low, byValue);
+		const auto last = std::upper_bound(first, set.Thresholds.end(), high, [](float value, const FThreshold& t) { return value < t.Value; });
+
+		const auto visit = [&](FThreshold& t) {
+			if (bRising) {
+				if (newValue >= t.Value + t.Hysteresis) {
+					t.bFallingArmed = true;
+				}
+				if (oldValue < t.Value && newValue >= t.Value && t.bRisingArmed) {
+					t.bRisingArmed = false;
+					if (static_cast<uint8_t>(t.Direction) & static_cast<uint8_t>(EThresholdDirection::Rising)) {
+						outCrossings.push_back({ t.Id, true });
+					}
+				}
+			}
+			else {
+				if (newValue <= t.Value - t.Hysteresis) {
+					t.bRisingArmed = true;
+				}
+				if (oldValue > t.Value && newValue <= t.Value && t.bFallingArmed) {
+					t.bFallingArmed = false;
+					if (static_cast<uint8_t>(t.Direction) & static_cast<uint8_t>(EThresholdDirection::Falling)) {
+						outCrossings.push_back({ t.Id, false });
+					}
+				}
+			}
+		};
+		if (bRising) {
+			for (auto it = first; it != last; ++it) {
+				visit(*it);
+			}
+		}
+		else {
+			for (auto it = last; it != first;) {
+				visit(*--it);
+			}
+		}
+	}
+
+	bool AcceptsDamageType(const FModificationRule& rule, FTypeId damageType, const FDamageTypeOps& ops) {
+		if (rule.DamageTypes.empty() || std::find(rule.DamageTypes.begin(), rule.DamageTypes.end(), damageType) != rule.DamageTypes.end()) {
+			return true;
+		}
+		if (!rule.bIncludeChildTypes || !ops.IsChildOf || damageType == 0) {
+			return false;
+		}
+		for (FTypeId parent : rule.DamageTypes) {
+			if (ops.IsChildOf(damageType, parent)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	bool RuleMatches(const FModificationRule& rule, const FDamageQuery& query, const FDamageTypeOps& ops) {
+		if (rule.Channel != EDamageChannel::All && rule.Channel != query.Channel) {
+			return false;
+		}
+		if (query.Channel == EDamageChannel::Point && !rule.Bones.empty()
+			&& std::find(rule.Bones.begin(), rule.Bones.end(), query.Bone) == rule.Bones.end()) {
+			return false;
+		}
+		if ((rule.MinimumRange > 0 && query.Distance < rule.MinimumRange) || (rule.MaximumRange > 0 && query.Distance > rule.MaximumRange)) {
+			return false;
+		}
+		return AcceptsDamageType(rule, query.DamageType, ops);
+	}
+	float ModifyDamage(const FModificationRule* rules, int32_t numRules, const FDamageQuery& query, const FDamageTypeOps& ops) {
+		float modifiedDamage = query.Damage;
+		for (int32_t i = 0; i < numRules; i++) {
+			const FModificationRule& rule = rules[i];
+			if (!RuleMatches(rule, query, ops)) {
+				continue;
+			}
+			switch (rule.Type) {
+			case EModificationType::Override:
+				return rule.Magnitude;
+			case EModificationType::FromDamageType: {
+				// Matches the component: the damage type sees the unmodified damage.
+				float typeDamage = 0.f;
+				if (ops.ModifyFromDamageType && ops.ModifyFromDamageType(ops.Context, query.DamageType, query.Damage, typeDamage)) {
+					modifiedDamage = typeDamage;
+				}
+				break;
+			}
+			case EModificationType::Add:
+				modifiedDamage += rule.Magnitude;
+				break;
+			case EModificationType::Multiply:
+				modifiedDamage *= rule.Magnitude;
+				break;
+			}
+		}
+		return modifiedDamage;
+	}
+	bool FilterRules(const FModificationRule* rules, int32_t numRules, EDamageChannel channel, FTypeId damageType,
+		const FDamageTypeOps& ops, std::vector<FDamageStep>& outSteps) {
+		outSteps.clear();
+		for (int32_t i = 0; i < numRules; i++) {
+			const FModificationRule& rule = rules[i];
+			if ((rule.Channel != EDamageChannel::All && rule.Channel != channel) || !AcceptsDamageType(rule, damageType, ops)) {
+				continue;
+			}
+			if ((channel == EDamageChannel::Point && !rule.Bones.empty()) || rule.MinimumRange > 0 || rule.MaximumRange > 0) {
+				outSteps.clear();
+				return false;
+			}
+			outSteps.push_back({ rule.Type, rule.Magnitude });
+			if (rule.Type == EModificationType::Override) {
+				// Nothing after an override is evaluated.
+				break;
+			}
+		}
+		return true;
+	}
+	float ApplyDamageSteps(const std::vector<FDamageStep>& steps, const FDamageQuery& query, const FDamageTypeOps& ops) {
+		float modifiedDamage = query.Damage;
+		for (const FDamageStep& step : steps) {
+			switch (step.Type) {
+			case EModificationType::Override:
+				return step.Magnitude;
+			case EModificationType::FromDamageType: {
+				float typeDamage = 0.f;
+				if (ops.ModifyFromDamageType && ops.ModifyFromDamageType(ops.Context, query.DamageType, query.Damage, typeDamage)) {
+					modifiedDamage = typeDamage;
+				}
+				break;
+			}
+			case EModificationType::Add:
+				modifiedDamage += step.Magnitude;
+				break;
+			case EModificationType::Multiply:
+				modifiedDamage *= step.Magnitude;
+				break;
+			}
+		}
+		return modifiedDamage;
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright LyCH. 2024
+
+
+#include "Core/ResourceCoreUtils.h"
+#include "Components/ResourceComponentBase.h"
+#include "Interfaces/DamageTypeModificationInterface.h"
+
+//MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/DamageType.h"
+
+static_assert(static_cast<uint8>(EIncomingDamageChannel::GenericDamage) == static_cast<uint8>(ResourceCore::EDamageChannel::Generic), "EIncomingDamageChannel and ResourceCore::EDamageChannel must match.");
+static_assert(static_cast<uint8>(EIncomingDamageModificationType::Modify_From_DamageType) == static_cast<uint8>(ResourceCore::EModificationType::FromDamageType), "EIncomingDamageModificationType and ResourceCore::EModificationType must match.");
+static_assert(static_cast<uint8>(RSO_Override) == static_cast<uint8>(ResourceCore::EStatOperation::Override), "EResourceStatOperation and ResourceCore::EStatOperation must match.");
+
+namespace ResourceCore {
+	namespace {
+		bool IsChildOf(FTypeId child, FTypeId parent) {
+			const UClass* childClass = reinterpret_cast<const UClass*>(child);
+			return childClass && childClass->IsChildOf(reinterpret_cast<const UClass*>(parent));
+		}
+		bool ModifyFromDamageType(const void* context, FTypeId damageType, float damage, float& outDamage) {
+			const UClass* damageClass = reinterpret_cast<const UClass*>(damageType);
+			if (!damageClass || !damageClass->ImplementsInterface(UDamageTypeModificationInterface::StaticClass())) {
+				return false;
+			}
+			AActor* damagedActor = const_cast<AActor*>(static_cast<const AActor*>(context));
+			outDamage = IDamageTypeModificationInterface::Execute_ModifyDamage(damageClass->GetDefaultObject(), damage, damagedActor);
+			return true;
+		}
+	}
+
+	EDamageChannel ToCoreChannel(EIncomingDamageChannel channel) {
+		return static_cast<EDamageChannel>(static_cast<uint8>(channel));
+	}
+	FNameId MakeNameId(FName name) {
+		return (static_cast<uint64>(name.GetComparisonIndex().ToUnstableInt()) << 32) | static_cast<uint32>(name.GetNumber());
+	}
+	FTypeId MakeTypeId(const UDamageType* damageType) {
+		return damageType ? MakeTypeId(damageType->GetClass()) : 0;
+	}
+	FTypeId MakeTypeId(const UClass* damageClass) {
+		return reinterpret_cast<FTypeId>(damageClass);
+	}
+	FModificationRule MakeRule(const FIncomingDamageModification& modification) {
+		FModificationRule rule;
+		rule.Channel = ToCoreChannel(modification.DamageChannel);
+		rule.Type = static_cast<EModificationType>(static_cast<uint8>(modification.ModificationType));
+		rule.Magnitude = modification.Magnitude;
+		rule.MinimumRange = modification.MinimumRange;
+		rule.MaximumRange = modification.MaximumRange;
+		rule.bIncludeChildTypes = modification.bWhitelistChildDamageTypes;
+		rule.Bones.reserve(modification.WhitelistedBoneNames.Num());
+		for (const FName& bone : modification.WhitelistedBoneNames) {
+			rule.Bones.push_back(MakeNameId(bone));
+		}
+		rule.DamageTypes.reserve(modification.WhitelistedDamageTypes.Num());
+		for (const TSubclassOf<UDamageType>& damageClass : modification.WhitelistedDamageTypes) {
+			rule.DamageTypes.push_back(MakeTypeId(damageClass.Get()));
+		}
+		return rule;
+	}
+	void MakeRules(TConstArrayView<FIncomingDamageModification> modifications, std::vector<FModificationRule>& outRules) {
+		outRules.clear();
+		outRules.reserve(modifications.Num());
+		for (const FIncomingDamageModification& modification : modifications) {
+			outRules.push_back(MakeRule(modification));
+		}
+	}
+	FDamageTypeOps MakeDamageTypeOps(const AActor* damagedActor) {
+		FDamageTypeOps ops;
+		ops.IsChildOf = &IsChildOf;
+		ops.ModifyFromDamageType = &ModifyFromDamageType;
+		ops.Context = damagedActor;
+		return ops;
+	}
+}
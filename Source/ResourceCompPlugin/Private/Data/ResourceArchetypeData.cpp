@@ -0,0 +1,51 @@
+// Copyright LyCH. 2024
+
+
+#include "Data/ResourceArchetypeData.h"
+#include "Core/ResourceCoreUtils.h"
+
+const FResourceSharedRules& UResourceArchetypeData::GetSharedRules(const UDamageModificationData* extraData) const {
+	check(IsInGameThread());
+	FResourceSharedRules* sharedRules = &SharedRules;
+	if (IsValid(extraData)) {
+		TUniquePtr<FResourceSharedRules>& extendedRules = ExtendedRules.FindOrAdd(extraData);
+		if (!extendedRules.IsValid()) {
+			extendedRules = MakeUnique<FResourceSharedRules>();
+		}
+		sharedRules = extendedRules.Get();
+	}
+	if (!sharedRules->bBuilt) {
+		sharedRules->Rules = ModificationRules;
+		if (IsValid(DefaultModificationData)) {
+			sharedRules->Rules.Append(DefaultModificationData->Modifications);
+		}
+		if (IsValid(extraData)) {
+			sharedRules->Rules.Append(extraData->Modifications);
+		}
+		ResourceCore::MakeRules(sharedRules->Rules, sharedRules->CompiledRules);
+		sharedRules->bBuilt = true;
+	}
+	return *sharedRules;
+}
+
+void UResourceArchetypeData::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) {
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	SIZE_T sharedSize = SharedRules.Rules.GetAllocatedSize() + SharedRules.CompiledRules.capacity() * sizeof(ResourceCore::FModificationRule)
+		+ ExtendedRules.GetAllocatedSize();
+	for (const TPair<TObjectKey<UDamageModificationData>, TUniquePtr<FResourceSharedRules>>& extendedRules : ExtendedRules) {
+		sharedSize += sizeof(FResourceSharedRules) + extendedRules.Value->Rules.GetAllocatedSize()
+			+ extendedRules.Value->CompiledRules.capacity() * sizeof(ResourceCore::FModificationRule);
+	}
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(ModificationRules.GetAllocatedSize() + sharedSize);
+}
+
+#if WITH_EDITOR
+void UResourceArchetypeData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	// Rebuilt in place, so resources sharing them see the edit.
+	SharedRules.bBuilt = false;
+	for (TPair<TObjectKey<UDamageModificationData>, TUniquePtr<FResourceSharedRules>>& extendedRules : ExtendedRules) {
+		extendedRules.Value->bBuilt = false;
+	}
+}
+#endif
@@ -0,0 +1,17 @@
+// Copyright LyCH. 2024
+
+
+#include "Debug/ResourceBenchmarkActor.h"
+#include "Components/Health/HealthResource.h"
+#include "Components/LiteResourceComponent.h"
+#include "Components/SceneComponent.h"
+
+AResourceBenchmarkActor::AResourceBenchmarkActor() {
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	HealthResource = CreateDefaultSubobject<UHealthResource>(TEXT("HealthResource"));
+	LiteResource = CreateDefaultSubobject<ULiteResourceComponent>(TEXT("LiteResource"));
+}
@@ -0,0 +1,230 @@
+// Copyright LyCH. 2024
+
+// Native microbenchmarks. Each one is a console command so it can run in any build, including -nullrhi.
+
+#include "CoreMinimal.h"
+#include "Components/Health/HealthResource.h"
+#include "Components/LiteResourceComponent.h"
+#include "Core/ResourceCore.h"
+#include "Core/ResourceCorePolicies.h"
+#include "Data/ResourceArchetypeData.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Subsystems/OverheadBarBatchRenderer.h"
+#include "ResourceCompPlugin.h"
+#include "UObject/Package.h"
+
+//MP Reqs
+#include "GameFramework/DamageType.h"
+
+/*
+ * Bytes per health resource with per-instance rules and with a shared archetype.
+ * A friend of UHealthResource so it can fill the rules the way BeginPlay would, without a world.
+ */
+struct FResourceMemoryReport {
+	static SIZE_T MeasureInstance(UHealthResource* health) {
+		return health->GetClass()->GetStructureSize() + health->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	static void Run(const TArray<FString>& args) {
+		const int32 count = args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*args[0])) : 10000;
+		const int32 numRules = args.IsValidIndex(1) ? FMath::Max(0, FCString::Atoi(*args[1])) : 8;
+
+		UResourceArchetypeData* archetype = NewObject<UResourceArchetypeData>(GetTransientPackage());
+		for (int32 r = 0; r < numRules; r++) {
+			FIncomingDamageModification& rule = archetype->ModificationRules.AddDefaulted_GetRef();
+			rule.ModificationName = FName(TEXT("Rule"), r);
+			rule.WhitelistedBoneNames = { TEXT("head"), TEXT("neck_01"), TEXT("spine_03") };
+			rule.WhitelistedDamageTypes = { UDamageType::StaticClass() };
+		}
+		archetype->GetSharedRules();
+
+		TArray<TObjectPtr<UHealthResource>> instances;
+		instances.Reserve(count);
+		SIZE_T perInstanceTotal = 0;
+		for (int32 i = 0; i < count; i++) {
+			UHealthResource* health = NewObject<UHealthResource>(GetTransientPackage());
+			health->GetMutableModificationRules() = archetype->ModificationRules;
+			health->UpdateCompiledRules();
+			perInstanceTotal += MeasureInstance(health);
+			instances.Add(health);
+		}
+		instances.Reset();
+
+		SIZE_T sharedTotal = archetype->GetResourceSizeBytes(EResourceSizeMode::Exclusive) + archetype->GetClass()->GetStructureSize();
+		for (int32 i = 0; i < count; i++) {
+			UHealthResource* health = NewObject<UHealthResource>(GetTransientPackage());
+			health->Archetype = archetype;
+			health->bUsesArchetypeRules = true;
+			health->UpdateCompiledRules();
+			sharedTotal += MeasureInstance(health);
+			instances.Add(health);
+		}
+		instances.Reset();
+
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.ArchetypeMemory: %d health resources, %d rules each."), count, numRules);
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.ArchetypeMemory: per-instance rules %.1f bytes/component, %.2f MB total"),
+			static_cast<double>(perInstanceTotal) / count, perInstanceTotal / (1024.0 * 1024.0));
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.ArchetypeMemory: shared archetype %.1f bytes/component, %.2f MB total (including the archetype)"),
+			static_cast<double>(sharedTotal) / count, sharedTotal / (1024.0 * 1024.0));
+	}
+};
+
+namespace ResourceBenchmarks {
+	volatile float Sink = 0.f;
+
+	double NanosecondsPerOp(double startSeconds, int64 ops) {
+		return (FPlatformTime::Seconds() - startSeconds) * 1e9 / FMath::Max<int64>(ops, 1);
+	}
+
+	void BenchCore(const TArray<FString>& args) {
+		const int64 iterations = args.IsValidIndex(0) ? FMath::Max<int64>(1, FCString::Atoi64(*args[0])) : 10000000;
+
+		/* Add/Drain */ {
+			ResourceCore::FResourceState state;
+			const ResourceCore::FRegenParams params;
+			const double start = FPlatformTime::Seconds();
+			for (int64 i = 0; i < iterations; i++) {
+				ResourceCore::Drain(state, 7.f, static_cast<double>(i), params);
+				ResourceCore::Add(state, 5.f, static_cast<double>(i), params);
+			}
+			Sink = state.Current;
+			UE_LOG(LogResourceComp, Log, TEXT("Bench.Core: Add+Drain %.2f ns/op"), NanosecondsPerOp(start, iterations * 2));
+		}
+		/* Add/Drain, fixed policies */ {
+			ResourceCore::FResourceState state;
+			const ResourceCore::FRegenParams params;
+			const double start = FPlatformTime::Seconds();
+			for (int64 i = 0; i < iterations; i++) {
+				ResourceCore::FManaResourceCore::Drain(state, 7.f, static_cast<double>(i), params);
+				ResourceCore::FManaResourceCore::Add(state, 5.f, static_cast<double>(i), params);
+			}
+			Sink = state.Current;
+			UE_LOG(LogResourceComp, Log, TEXT("Bench.Core: Add+Drain (FManaResourceCore) %.2f ns/op"), NanosecondsPerOp(start, iterations * 2));
+		}
+		/* Regen catch-up */ {
+			ResourceCore::FResourceState state;
+			const ResourceCore::FRegenParams params;
+			const double start = FPlatformTime::Seconds();
+			double now = 0.0;
+			for (int64 i = 0; i < iterations; i++) {
+				if (state.NextRegenTime < 0) {
+					ResourceCore::Drain(state, 50.f, now, params);
+				}
+				now += 0.1;
+				ResourceCore::AdvanceRegen(state, now, params);
+			}
+			Sink = state.Current;
+			UE_LOG(LogResourceComp, Log, TEXT("Bench.Core: AdvanceRegen %.2f ns/op"), NanosecondsPerOp(start, iterations));
+		}
+		/* ModifyDamage */ {
+			std::vector<ResourceCore::FModificationRule> rules(8);
+			for (int32 r = 0; r < 8; r++) {
+				rules[r].Type = r % 2 ? ResourceCore::EModificationType::Multiply : ResourceCore::EModificationType::Add;
+				rules[r].Magnitude = r % 2 ? 0.9f : 1.f;
+				rules[r].Channel = static_cast<ResourceCore::EDamageChannel>(r % 4);
+				rules[r].MaximumRange = r == 3 ? 1000.f : 0.f;
+				if (r == 5) {
+					rules[r].Bones = { 1, 2, 3 };
+				}
+			}
+			const ResourceCore::FDamageTypeOps ops;
+			ResourceCore::FDamageQuery query;
+			query.Channel = ResourceCore::EDamageChannel::Point;
+			query.Bone = 2;
+			float total = 0.f;
+			const double start = FPlatformTime::Seconds();
+			for (int64 i = 0; i < iterations; i++) {
+				query.Damage = static_cast<float>(i & 63);
+				query.Distance = static_cast<float>(i & 2047);
+				total += ResourceCore::ModifyDamage(rules, query, ops);
+			}
+			Sink = total;
+			UE_LOG(LogResourceComp, Log, TEXT("Bench.Core: ModifyDamage (8 rules) %.2f ns/op"), NanosecondsPerOp(start, iterations));
+		}
+	}
+
+	void BenchLite(const TArray<FString>& args) {
+		const int32 count = args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*args[0])) : 10000;
+		const int64 hits = args.IsValidIndex(1) ? FMath::Max<int64>(1, FCString::Atoi64(*args[1])) : 1000000;
+
+		const int32 componentBytes = UActorComponent::StaticClass()->GetStructureSize();
+		const int32 liteBytes = ULiteResourceComponent::StaticClass()->GetStructureSize() - componentBytes;
+		const int32 baseBytes = UResourceComponentBase::StaticClass()->GetStructureSize() - componentBytes;
+		const int32 healthBytes = UHealthResource::StaticClass()->GetStructureSize() - componentBytes;
+		const bool bMemoryPass = liteBytes <= ULiteResourceComponent::BudgetBytesPerInstance;
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.Lite: bytes over UActorComponent: lite %d, resource base %d, health %d"), liteBytes, baseBytes, healthBytes);
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.Lite: memory %s (%d / %d bytes)"), bMemoryPass ? TEXT("PASS") : TEXT("FAIL"),
+			liteBytes, ULiteResourceComponent::BudgetBytesPerInstance);
+
+		TArray<TObjectPtr<ULiteResourceComponent>> instances;
+		instances.Reserve(count);
+		for (int32 i = 0; i < count; i++) {
+			instances.Add(NewObject<ULiteResourceComponent>(GetTransientPackage()));
+		}
+		const double start = FPlatformTime::Seconds();
+		for (int64 i = 0; i < hits; i++) {
+			ULiteResourceComponent* lite = instances[static_cast<int32>(i % count)];
+			lite->DrainResource(1.f);
+			if ((i & 31) == 0) {
+				lite->AddResource(32.f);
+			}
+		}
+		const double nsPerHit = NanosecondsPerOp(start, hits);
+		Sink = instances[0]->GetCurrentAmount();
+		const bool bCpuPass = nsPerHit <= ULiteResourceComponent::BudgetNanosecondsPerHit;
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.Lite: %d components, %lld hits, %.2f ns/hit"), count, hits, nsPerHit);
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.Lite: cpu %s (%.2f / %.2f ns)"), bCpuPass ? TEXT("PASS") : TEXT("FAIL"),
+			nsPerHit, ULiteResourceComponent::BudgetNanosecondsPerHit);
+	}
+
+	void BenchOverheadBatch(const TArray<FString>& args) {
+		const int32 count = args.IsValidIndex(0) ? FMath::Max(1, FCString::Atoi(*args[0])) : 1000;
+		const int32 iterations = args.IsValidIndex(1) ? FMath::Max(1, FCString::Atoi(*args[1])) : 1000;
+
+		// Bars on a grid in front of the view, with no owners, so nothing here needs a world or a renderer.
+		TArray<TObjectPtr<UHealthResource>> resources;
+		TArray<FOverheadBarSource> sources;
+		resources.Reserve(count);
+		sources.Reserve(count);
+		for (int32 i = 0; i < count; i++) {
+			UHealthResource* resource = resources.Add_GetRef(NewObject<UHealthResource>(GetTransientPackage()));
+			FOverheadBarSource& source = sources.AddDefaulted_GetRef();
+			source.Resource = resource;
+			source.Offset = FVector(100.f + (i / 32) * 100.f, (i % 32) * 100.f - 1600.f, 100.f);
+			source.StyleId = static_cast<uint8>(i % 4);
+		}
+
+		TArray<FOverheadBarInstance> instances;
+		instances.Reserve(count);
+		const double start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < iterations; i++) {
+			instances.Reset();
+			UOverheadBarBatchRenderer::BuildInstances(sources, FVector::ZeroVector, FVector::ForwardVector, 1e6f, false, instances);
+		}
+		const double nsPerBatch = NanosecondsPerOp(start, iterations);
+		Sink = instances.Num() > 0 ? instances.Last().Percent : 0.f;
+		UE_LOG(LogResourceComp, Log, TEXT("Bench.OverheadBatch: %d bars, %d built, %.2f us/batch, %.2f ns/bar"),
+			count, instances.Num(), nsPerBatch / 1000.0, nsPerBatch / count);
+	}
+
+	static FAutoConsoleCommand CoreCommand(
+		TEXT("ResourceComp.Bench.Core"),
+		TEXT("Microbenchmarks the engine-independent resource math. Args: [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchCore));
+
+	static FAutoConsoleCommand ArchetypeMemoryCommand(
+		TEXT("ResourceComp.Bench.ArchetypeMemory"),
+		TEXT("Reports bytes per health resource with per-instance rules and with a shared archetype. Args: [Count=10000] [RulesPerResource=8]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FResourceMemoryReport::Run));
+
+	static FAutoConsoleCommand LiteCommand(
+		TEXT("ResourceComp.Bench.Lite"),
+		TEXT("Checks ULiteResourceComponent against its memory and per-hit budgets. Args: [Count=10000] [Hits=1000000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchLite));
+
+	static FAutoConsoleCommand OverheadBatchCommand(
+		TEXT("ResourceComp.Bench.OverheadBatch"),
+		TEXT("Times building the batched overhead bar instances on the CPU. Runs under -nullrhi. Args: [Bars=1000] [Iterations=1000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchOverheadBatch));
+}
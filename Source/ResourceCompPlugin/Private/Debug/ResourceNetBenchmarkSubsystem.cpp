@@ -0,0 +1,310 @@
+// Copyright LyCH. 2024
+
+
+#include "Debug/ResourceNetBenchmarkSubsystem.h"
+#include "Debug/ResourceBenchmarkActor.h"
+#include "Debug/ResourceNetStats.h"
+#include "Components/Health/HealthResource.h"
+#include "Components/LiteResourceComponent.h"
+#include "ResourceCompPlugin.h"
+
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+//MP Reqs
+#include "GameFramework/DamageType.h"
+
+namespace ResourceNetBenchmark {
+	static const FName ModifierName = "NetBench";
+
+	void ForEachGameWorld(TFunctionRef<void(UWorld*, UResourceNetBenchmarkSubsystem*)> func) {
+		if (!GEngine) {
+			return;
+		}
+		for (const FWorldContext& context : GEngine->GetWorldContexts()) {
+			UWorld* world = context.World();
+			if (!IsValid(world) || !world->IsGameWorld()) {
+				continue;
+			}
+			if (UResourceNetBenchmarkSubsystem* subsystem = world->GetSubsystem<UResourceNetBenchmarkSubsystem>()) {
+				func(world, subsystem);
+			}
+		}
+	}
+
+	void StartAll(const FResourceNetBenchmarkSettings& settings) {
+		FResourceNetStats::Get().Reset();
+		FResourceNetStats::Get().SetEnabled(true);
+		ForEachGameWorld([&settings](UWorld* world, UResourceNetBenchmarkSubsystem* subsystem) {
+			if (world->GetNetMode() == NM_Client) {
+				subsystem->StartSampling();
+			}
+			else if (world->GetNetMode() != NM_Standalone) {
+				subsystem->StartWorkload(settings);
+			}
+		});
+	}
+
+	void StopAll() {
+		ForEachGameWorld([](UWorld* world, UResourceNetBenchmarkSubsystem* subsystem) {
+			if (subsystem->IsRunning()) {
+				subsystem->StopBenchmark();
+			}
+		});
+		FResourceNetStats::Get().SetEnabled(false);
+	}
+
+	static FAutoConsoleCommand StartCommand(
+		TEXT("ResourceComp.NetBench.Start"),
+		TEXT("Starts the resource replication benchmark. Args: [NumActors] [Duration] [HitsPerSecond] [Damage] [ModifierInterval]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+			FResourceNetBenchmarkSettings settings;
+			if (args.IsValidIndex(0)) { settings.NumActors = FMath::Max(1, FCString::Atoi(*args[0])); }
+			if (args.IsValidIndex(1)) { settings.Duration = FCString::Atof(*args[1]); }
+			if (args.IsValidIndex(2)) { settings.HitsPerSecond = FCString::Atof(*args[2]); }
+			if (args.IsValidIndex(3)) { settings.Damage = FCString::Atof(*args[3]); }
+			if (args.IsValidIndex(4)) { settings.ModifierInterval = FCString::Atof(*args[4]); }
+			StartAll(settings);
+		}));
+
+	static FAutoConsoleCommand StopCommand(
+		TEXT("ResourceComp.NetBench.Stop"),
+		TEXT("Stops the resource replication benchmark and prints the report."),
+		FConsoleCommandDelegate::CreateStatic(&StopAll));
+
+	const TCHAR* GetReplicationSystemName(const UWorld* world) {
+		const UNetDriver* driver = IsValid(world) ? world->GetNetDriver() : nullptr;
+		if (!IsValid(driver)) {
+			return TEXT("no net driver");
+		}
+		return driver->IsUsingIrisReplication() ? TEXT("Iris") : TEXT("legacy");
+	}
+}
+
+void UResourceNetBenchmarkSubsystem::StartWorkload(const FResourceNetBenchmarkSettings& settings) {
+	UWorld* world = GetWorld();
+	if (bRunning || !IsValid(world) || world->GetNetMode() == NM_Client) {
+		return;
+	}
+	Settings = settings;
+	bRunning = true;
+	bServer = true;
+	Elapsed = 0.f;
+	NextHitTime = 0.f;
+	NextModifierTime = Settings.ModifierInterval;
+	HitCount = 0;
+	bModifierGiven = false;
+	ConnectionBytes.Reset();
+
+	const int32 rowLength = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Settings.NumActors)));
+	for (int32 i = 0; i < Settings.NumActors; i++) {
+		const FVector location(200.f * (i % rowLength), 200.f * (i / rowLength), 0.f);
+		if (AResourceBenchmarkActor* target = world->SpawnActor<AResourceBenchmarkActor>(location, FRotator::ZeroRotator)) {
+			Targets.Add(target);
+		}
+	}
+	UE_LOG(LogResourceComp, Log, TEXT("NetBench: %s started with %d targets for %.1fs."), *world->GetDebugDisplayName(), Targets.Num(), Settings.Duration);
+}
+
+void UResourceNetBenchmarkSubsystem::StartSampling() {
+	if (bRunning) {
+		return;
+	}
+	bRunning = true;
+	bServer = false;
+	Elapsed = 0.f;
+	ConnectionBytes.Reset();
+	ClearSnapshots();
+}
+
+void UResourceNetBenchmarkSubsystem::StopBenchmark() {
+	if (!bRunning) {
+		return;
+	}
+	Report();
+	bRunning = false;
+	for (AResourceBenchmarkActor* target : Targets) {
+		if (IsValid(target)) {
+			target->Destroy();
+		}
+	}
+	Targets.Reset();
+	ClearSnapshots();
+}
+
+void UResourceNetBenchmarkSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	if (!bRunning) {
+		return;
+	}
+	Elapsed += DeltaTime;
+	SampleConnections(DeltaTime);
+	if (bServer) {
+		TickWorkload(DeltaTime);
+		if (Elapsed >= Settings.Duration) {
+			ResourceNetBenchmark::StopAll();
+		}
+	}
+	else {
+		TickSampling();
+	}
+}
+
+TStatId UResourceNetBenchmarkSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceNetBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UResourceNetBenchmarkSubsystem::Deinitialize() {
+	ClearSnapshots();
+	Super::Deinitialize();
+}
+
+void UResourceNetBenchmarkSubsystem::TickWorkload(float deltaTime) {
+	if (Targets.Num() == 0) {
+		return;
+	}
+	/* Damage */ {
+		const float hitInterval = Settings.HitsPerSecond > 0 ? 1.f / Settings.HitsPerSecond : -1.f;
+		while (hitInterval > 0 && Elapsed >= NextHitTime) {
+			for (int32 i = 0; i < Targets.Num(); i++) {
+				AResourceBenchmarkActor* target = Targets[i];
+				AResourceBenchmarkActor* causer = Targets[(i + 1) % Targets.Num()];
+				if (!IsValid(target) || !IsValid(causer)) {
+					continue;
+				}
+				if (HitCount % 2 == 0) {
+					FHitResult hit;
+					hit.Location = target->GetActorLocation();
+					hit.TraceStart = causer->GetActorLocation();
+					const FVector shotDirection = (hit.Location - hit.TraceStart).GetSafeNormal();
+					UGameplayStatics::ApplyPointDamage(target, Settings.Damage, shotDirection, hit, nullptr, causer, UDamageType::StaticClass());
+				}
+				else {
+					UGameplayStatics::ApplyDamage(target, Settings.Damage, nullptr, causer, UDamageType::StaticClass());
+				}
+				if (IsValid(target->GetLiteResource())) {
+					target->GetLiteResource()->DrainResource(Settings.Damage);
+				}
+			}
+			HitCount++;
+			NextHitTime += hitInterval;
+		}
+	}
+	/* Modifier churn */ {
+		if (Settings.ModifierInterval > 0 && Elapsed >= NextModifierTime) {
+			for (AResourceBenchmarkActor* target : Targets) {
+				if (!IsValid(target) || !IsValid(target->GetHealthResource())) {
+					continue;
+				}
+				if (bModifierGiven) {
+					target->GetHealthResource()->RemoveModifier(ResourceNetBenchmark::ModifierName);
+				}
+				else {
+					FIncomingDamageModification modifier;
+					modifier.ModificationName = ResourceNetBenchmark::ModifierName;
+					target->GetHealthResource()->GiveModifier(modifier);
+				}
+			}
+			bModifierGiven = !bModifierGiven;
+			NextModifierTime += Settings.ModifierInterval;
+		}
+	}
+}
+
+void UResourceNetBenchmarkSubsystem::TickSampling() {
+	for (TActorIterator<AResourceBenchmarkActor> it(GetWorld()); it; ++it) {
+		for (UActorComponent* component : { static_cast<UActorComponent*>(it->GetHealthResource()), static_cast<UActorComponent*>(it->GetLiteResource()) }) {
+			SampleComponent(component);
+		}
+	}
+}
+
+void UResourceNetBenchmarkSubsystem::SampleComponent(UActorComponent* component) {
+	if (!IsValid(component)) {
+		return;
+	}
+	FComponentSnapshot* snapshot = Snapshots.FindByPredicate([component](const FComponentSnapshot& s) { return s.Component == component; });
+	const bool bNewComponent = snapshot == nullptr;
+	if (bNewComponent) {
+		snapshot = &Snapshots.AddDefaulted_GetRef();
+		snapshot->Component = component;
+		for (TFieldIterator<FProperty> propIt(component->GetClass()); propIt; ++propIt) {
+			if (propIt->HasAnyPropertyFlags(CPF_Net)) {
+				FPropertySnapshot& prop = snapshot->Properties.AddDefaulted_GetRef();
+				prop.Property = *propIt;
+				prop.Value = static_cast<uint8*>(FMemory::Malloc(propIt->GetSize(), propIt->GetMinAlignment()));
+				propIt->InitializeValue(prop.Value);
+			}
+		}
+	}
+	for (FPropertySnapshot& prop : snapshot->Properties) {
+		const void* current = prop.Property->ContainerPtrToValuePtr<void>(component);
+		if (!prop.Property->Identical(prop.Value, current)) {
+			// The first sample is the initial bunch, which is not part of the workload.
+			if (!bNewComponent) {
+				FResourceNetStats::Get().RecordProperty(this, prop.Property->GetFName());
+			}
+			prop.Property->CopyCompleteValue(prop.Value, current);
+		}
+	}
+}
+
+void UResourceNetBenchmarkSubsystem::SampleConnections(float deltaTime) {
+	UNetDriver* driver = GetWorld()->GetNetDriver();
+	if (!IsValid(driver)) {
+		return;
+	}
+	if (!bServer) {
+		if (IsValid(driver->ServerConnection)) {
+			ConnectionBytes.FindOrAdd(driver->ServerConnection->GetName()) += static_cast<double>(driver->ServerConnection->InBytesPerSecond) * deltaTime;
+		}
+		return;
+	}
+	for (UNetConnection* connection : driver->ClientConnections) {
+		if (IsValid(connection)) {
+			ConnectionBytes.FindOrAdd(connection->GetName()) += static_cast<double>(connection->OutBytesPerSecond) * deltaTime;
+		}
+	}
+}
+
+void UResourceNetBenchmarkSubsystem::ClearSnapshots() {
+	for (FComponentSnapshot& snapshot : Snapshots) {
+		for (FPropertySnapshot& prop : snapshot.Properties) {
+			prop.Property->DestroyValue(prop.Value);
+			FMemory::Free(prop.Value);
+		}
+	}
+	Snapshots.Reset();
+}
+
+void UResourceNetBenchmarkSubsystem::Report() const {
+	const FString worldName = GetWorld()->GetDebugDisplayName();
+	const double seconds = FMath::Max(Elapsed, UE_SMALL_NUMBER);
+	if (bServer) {
+		UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]: %d targets, %.1fs, %d hit waves, %s replication."), *worldName, Targets.Num(), Elapsed, HitCount,
+			ResourceNetBenchmark::GetReplicationSystemName(GetWorld()));
+		for (const TPair<FString, double>& connection : ConnectionBytes) {
+			UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]   %s: %.1f bytes/s out"), *worldName, *connection.Key, connection.Value / seconds);
+		}
+		return;
+	}
+	UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]: received over %.1fs, %s replication"), *worldName, Elapsed, ResourceNetBenchmark::GetReplicationSystemName(GetWorld()));
+	for (const TPair<FString, double>& connection : ConnectionBytes) {
+		UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]   %s: %.1f bytes/s in"), *worldName, *connection.Key, connection.Value / seconds);
+	}
+	const FResourceNetStats::FConnectionStats* stats = FResourceNetStats::Get().GetConnections().Find(worldName);
+	if (!stats) {
+		UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]: no resource RPCs or property changes."), *worldName);
+		return;
+	}
+	for (const TPair<FName, FResourceNetStats::FEntry>& rpc : stats->RPCs) {
+		UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]   RPC %s: %.1f/s"), *worldName, *rpc.Key.ToString(), rpc.Value.Count / seconds);
+	}
+	for (const TPair<FName, FResourceNetStats::FEntry>& prop : stats->Properties) {
+		UE_LOG(LogResourceComp, Log, TEXT("NetBench [%s]   Property %s: %.1f changes/s (compared once per frame)"), *worldName, *prop.Key.ToString(), prop.Value.Count / seconds);
+	}
+}
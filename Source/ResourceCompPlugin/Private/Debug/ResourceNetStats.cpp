@@ -0,0 +1,32 @@
+// Copyright LyCH. 2024
+
+
+#include "Debug/ResourceNetStats.h"
+#include "Engine/World.h"
+
+FResourceNetStats& FResourceNetStats::Get() {
+	static FResourceNetStats instance;
+	return instance;
+}
+
+void FResourceNetStats::RecordRPC(const UObject* context, FName rpcName) {
+	if (FConnectionStats* connection = FindConnection(context)) {
+		connection->RPCs.FindOrAdd(rpcName).Count++;
+	}
+}
+void FResourceNetStats::RecordProperty(const UObject* context, FName propertyName) {
+	if (FConnectionStats* connection = FindConnection(context)) {
+		connection->Properties.FindOrAdd(propertyName).Count++;
+	}
+}
+
+FResourceNetStats::FConnectionStats* FResourceNetStats::FindConnection(const UObject* context) {
+	if (!bEnabled || !IsValid(context)) {
+		return nullptr;
+	}
+	UWorld* world = context->GetWorld();
+	if (!IsValid(world) || world->GetNetMode() != NM_Client) {
+		return nullptr;
+	}
+	return &Connections.FindOrAdd(world->GetDebugDisplayName());
+}
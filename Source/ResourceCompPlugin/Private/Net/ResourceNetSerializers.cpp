@@ -0,0 +1,413 @@
+// Copyright LyCH. 2024
+
+
+#include "Net/ResourceNetSerializers.h"
+
+#if UE_WITH_IRIS
+#include "Components/LiteResourceComponent.h"
+#include "Components/ResourceComponentBase.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+
+namespace UE::Net {
+	namespace ResourceNetSerializers {
+		// Same layout as SerializePackedBits in ResourceComponentBase.cpp.
+		void WritePackedBits(FNetBitStreamWriter& writer, uint32 value) {
+			const uint32 bitCount = FResourceReplicatedState::GetPackedBitCount(value);
+			writer.WriteBits(bitCount, FResourceReplicatedState::BitCountBits);
+			if (bitCount > 0U) {
+				writer.WriteBits(value, bitCount);
+			}
+		}
+		uint32 ReadPackedBits(FNetBitStreamReader& reader) {
+			const uint32 bitCount = FMath::Min(reader.ReadBits(FResourceReplicatedState::BitCountBits), 32U);
+			return bitCount > 0U ? reader.ReadBits(bitCount) : 0U;
+		}
+	}
+
+	struct FLiteResourceStateNetSerializer {
+		static constexpr uint32 Version = 0;
+
+		// Same flags as FLiteResourceState::NetSerialize.
+		enum : uint32 {
+			Flag_HasRegen = 1U,
+			Flag_FirstRegenTick = 2U,
+			FlagBits = 2U
+		};
+		struct FQuantizedType {
+			// Zero while regen is not scheduled, so every unscheduled state compares equal.
+			uint64 NextRegenTime;
+			uint32 Amount;
+			uint32 Flags;
+		};
+
+		typedef FLiteResourceState SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FLiteResourceStateNetSerializerConfig ConfigType;
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args);
+		static void Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args);
+		static void SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args);
+		static void DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args);
+		static void Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args);
+		static void Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args);
+		static bool IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args);
+		static bool Validate(FNetSerializationContext& context, const FNetValidateArgs& args);
+
+	private:
+		static void WriteRegenTime(FNetBitStreamWriter& writer, uint64 value) {
+			writer.WriteBits(static_cast<uint32>(value), 32U);
+			writer.WriteBits(static_cast<uint32>(value >> 32U), 32U);
+		}
+		static uint64 ReadRegenTime(FNetBitStreamReader& reader) {
+			const uint64 low = reader.ReadBits(32U);
+			const uint64 high = reader.ReadBits(32U);
+			return low | (high << 32U);
+		}
+
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates {
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+		static FLiteResourceStateNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+	UE_NET_IMPLEMENT_SERIALIZER(FLiteResourceStateNetSerializer);
+
+	const FLiteResourceStateNetSerializer::ConfigType FLiteResourceStateNetSerializer::DefaultConfig;
+
+	void FLiteResourceStateNetSerializer::Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		writer.WriteBits(value.Flags, FlagBits);
+		writer.WriteBits(value.Amount, 32U);
+		if (value.Flags & Flag_HasRegen) {
+			WriteRegenTime(writer, value.NextRegenTime);
+		}
+	}
+	void FLiteResourceStateNetSerializer::Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Flags = reader.ReadBits(FlagBits);
+		target.Amount = reader.ReadBits(32U);
+		target.NextRegenTime = (target.Flags & Flag_HasRegen) ? ReadRegenTime(reader) : 0U;
+	}
+	void FLiteResourceStateNetSerializer::SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		writer.WriteBits(value.Flags, FlagBits);
+		const bool bAmountChanged = value.Amount != prev.Amount;
+		writer.WriteBool(bAmountChanged);
+		if (bAmountChanged) {
+			writer.WriteBits(value.Amount, 32U);
+		}
+		if (value.Flags & Flag_HasRegen) {
+			const bool bRegenTimeChanged = value.NextRegenTime != prev.NextRegenTime;
+			writer.WriteBool(bRegenTimeChanged);
+			if (bRegenTimeChanged) {
+				WriteRegenTime(writer, value.NextRegenTime);
+			}
+		}
+	}
+	void FLiteResourceStateNetSerializer::DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Flags = reader.ReadBits(FlagBits);
+		target.Amount = reader.ReadBool() ? reader.ReadBits(32U) : prev.Amount;
+		if (target.Flags & Flag_HasRegen) {
+			target.NextRegenTime = reader.ReadBool() ? ReadRegenTime(reader) : prev.NextRegenTime;
+		}
+		else {
+			target.NextRegenTime = 0U;
+		}
+	}
+	void FLiteResourceStateNetSerializer::Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		const bool bHasRegen = source.NextRegenTime >= 0;
+		FMemory::Memcpy(&target.Amount, &source.Amount, sizeof(target.Amount));
+		target.NextRegenTime = 0U;
+		if (bHasRegen) {
+			FMemory::Memcpy(&target.NextRegenTime, &source.NextRegenTime, sizeof(target.NextRegenTime));
+		}
+		target.Flags = (bHasRegen ? Flag_HasRegen : 0U) | (source.bFirstRegenTick ? Flag_FirstRegenTick : 0U);
+	}
+	void FLiteResourceStateNetSerializer::Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args) {
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(args.Target);
+		FMemory::Memcpy(&target.Amount, &source.Amount, sizeof(target.Amount));
+		target.NextRegenTime = -1.0;
+		if (source.Flags & Flag_HasRegen) {
+			FMemory::Memcpy(&target.NextRegenTime, &source.NextRegenTime, sizeof(target.NextRegenTime));
+		}
+		target.bFirstRegenTick = (source.Flags & Flag_FirstRegenTick) != 0;
+	}
+	bool FLiteResourceStateNetSerializer::IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args) {
+		if (args.bStateIsQuantized) {
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(args.Source1);
+			return value0.Amount == value1.Amount && value0.NextRegenTime == value1.NextRegenTime && value0.Flags == value1.Flags;
+		}
+		const SourceType& value0 = *reinterpret_cast<const SourceType*>(args.Source0);
+		const SourceType& value1 = *reinterpret_cast<const SourceType*>(args.Source1);
+		// Unscheduled regen times are equal whatever their negative value, as they are once quantized.
+		const bool bRegenTimeEqual = value0.NextRegenTime < 0 ? value1.NextRegenTime < 0 : value0.NextRegenTime == value1.NextRegenTime;
+		return value0.Amount == value1.Amount && bRegenTimeEqual && value0.bFirstRegenTick == value1.bFirstRegenTick;
+	}
+	bool FLiteResourceStateNetSerializer::Validate(FNetSerializationContext& context, const FNetValidateArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		return FMath::IsFinite(source.Amount) && FMath::IsFinite(source.NextRegenTime);
+	}
+
+	static const FName PropertyNetSerializerRegistry_NAME_LiteResourceState("LiteResourceState");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_LiteResourceState, FLiteResourceStateNetSerializer);
+
+	FLiteResourceStateNetSerializer::FNetSerializerRegistryDelegates FLiteResourceStateNetSerializer::NetSerializerRegistryDelegates;
+
+	FLiteResourceStateNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates() {
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_LiteResourceState);
+	}
+	void FLiteResourceStateNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry() {
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_LiteResourceState);
+	}
+
+	struct FResourceReplicatedStateNetSerializer {
+		static constexpr uint32 Version = 0;
+
+		struct FQuantizedType {
+			uint32 Amount;
+			// Milliseconds.
+			uint32 TimeAtLastDrain;
+		};
+
+		typedef FResourceReplicatedState SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FResourceReplicatedStateNetSerializerConfig ConfigType;
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args);
+		static void Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args);
+		static void SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args);
+		static void DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args);
+		static void Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args);
+		static void Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args);
+		static bool IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args);
+		static bool Validate(FNetSerializationContext& context, const FNetValidateArgs& args);
+
+	private:
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates {
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+		static FResourceReplicatedStateNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+	UE_NET_IMPLEMENT_SERIALIZER(FResourceReplicatedStateNetSerializer);
+
+	const FResourceReplicatedStateNetSerializer::ConfigType FResourceReplicatedStateNetSerializer::DefaultConfig;
+
+	void FResourceReplicatedStateNetSerializer::Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		ResourceNetSerializers::WritePackedBits(writer, value.Amount);
+		ResourceNetSerializers::WritePackedBits(writer, value.TimeAtLastDrain);
+	}
+	void FResourceReplicatedStateNetSerializer::Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Amount = ResourceNetSerializers::ReadPackedBits(reader);
+		target.TimeAtLastDrain = ResourceNetSerializers::ReadPackedBits(reader);
+	}
+	void FResourceReplicatedStateNetSerializer::SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		const bool bAmountChanged = value.Amount != prev.Amount;
+		writer.WriteBool(bAmountChanged);
+		if (bAmountChanged) {
+			ResourceNetSerializers::WritePackedBits(writer, value.Amount);
+		}
+		// Drains move the time forward by a few seconds, which takes far fewer bits than the time itself.
+		const bool bDrainTimeChanged = value.TimeAtLastDrain != prev.TimeAtLastDrain;
+		writer.WriteBool(bDrainTimeChanged);
+		if (bDrainTimeChanged) {
+			const bool bForward = value.TimeAtLastDrain > prev.TimeAtLastDrain;
+			writer.WriteBool(bForward);
+			ResourceNetSerializers::WritePackedBits(writer, bForward ? value.TimeAtLastDrain - prev.TimeAtLastDrain : prev.TimeAtLastDrain - value.TimeAtLastDrain);
+		}
+	}
+	void FResourceReplicatedStateNetSerializer::DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Amount = reader.ReadBool() ? ResourceNetSerializers::ReadPackedBits(reader) : prev.Amount;
+		target.TimeAtLastDrain = prev.TimeAtLastDrain;
+		if (reader.ReadBool()) {
+			const bool bForward = reader.ReadBool();
+			const uint32 difference = ResourceNetSerializers::ReadPackedBits(reader);
+			target.TimeAtLastDrain = bForward ? prev.TimeAtLastDrain + difference : prev.TimeAtLastDrain - difference;
+		}
+	}
+	void FResourceReplicatedStateNetSerializer::Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		target.Amount = FResourceReplicatedState::QuantizeAmount(source.Amount);
+		target.TimeAtLastDrain = FResourceReplicatedState::QuantizeTime(source.TimeAtLastDrain);
+	}
+	void FResourceReplicatedStateNetSerializer::Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args) {
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(args.Target);
+		target.Amount = FResourceReplicatedState::DequantizeAmount(source.Amount);
+		target.TimeAtLastDrain = FResourceReplicatedState::DequantizeTime(source.TimeAtLastDrain);
+	}
+	bool FResourceReplicatedStateNetSerializer::IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args) {
+		if (args.bStateIsQuantized) {
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(args.Source1);
+			return value0.Amount == value1.Amount && value0.TimeAtLastDrain == value1.TimeAtLastDrain;
+		}
+		// Equal once quantized, so changes smaller than a step are not sent.
+		const SourceType& value0 = *reinterpret_cast<const SourceType*>(args.Source0);
+		const SourceType& value1 = *reinterpret_cast<const SourceType*>(args.Source1);
+		return FResourceReplicatedState::QuantizeAmount(value0.Amount) == FResourceReplicatedState::QuantizeAmount(value1.Amount)
+			&& FResourceReplicatedState::QuantizeTime(value0.TimeAtLastDrain) == FResourceReplicatedState::QuantizeTime(value1.TimeAtLastDrain);
+	}
+	bool FResourceReplicatedStateNetSerializer::Validate(FNetSerializationContext& context, const FNetValidateArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		return FMath::IsFinite(source.Amount) && FMath::IsFinite(source.TimeAtLastDrain);
+	}
+
+	static const FName PropertyNetSerializerRegistry_NAME_ResourceReplicatedState("ResourceReplicatedState");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceReplicatedState, FResourceReplicatedStateNetSerializer);
+
+	FResourceReplicatedStateNetSerializer::FNetSerializerRegistryDelegates FResourceReplicatedStateNetSerializer::NetSerializerRegistryDelegates;
+
+	FResourceReplicatedStateNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates() {
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceReplicatedState);
+	}
+	void FResourceReplicatedStateNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry() {
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceReplicatedState);
+	}
+
+	struct FResourceStatModifierNetSerializer {
+		static constexpr uint32 Version = 0;
+
+		struct FQuantizedType {
+			uint32 Magnitude;
+			uint8 Stat;
+			uint8 Operation;
+		};
+
+		typedef FResourceStatModifier SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FResourceStatModifierNetSerializerConfig ConfigType;
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args);
+		static void Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args);
+		static void SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args);
+		static void DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args);
+		static void Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args);
+		static void Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args);
+		static bool IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args);
+		static bool Validate(FNetSerializationContext& context, const FNetValidateArgs& args);
+
+	private:
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates {
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+		static FResourceStatModifierNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+	UE_NET_IMPLEMENT_SERIALIZER(FResourceStatModifierNetSerializer);
+
+	const FResourceStatModifierNetSerializer::ConfigType FResourceStatModifierNetSerializer::DefaultConfig;
+
+	void FResourceStatModifierNetSerializer::Serialize(FNetSerializationContext& context, const FNetSerializeArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		writer.WriteBits(value.Stat, FResourceStatModifier::StatBits);
+		writer.WriteBits(value.Operation, FResourceStatModifier::OperationBits);
+		writer.WriteBits(value.Magnitude, 32U);
+	}
+	void FResourceStatModifierNetSerializer::Deserialize(FNetSerializationContext& context, const FNetDeserializeArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Stat = static_cast<uint8>(reader.ReadBits(FResourceStatModifier::StatBits));
+		target.Operation = static_cast<uint8>(reader.ReadBits(FResourceStatModifier::OperationBits));
+		target.Magnitude = reader.ReadBits(32U);
+	}
+	void FResourceStatModifierNetSerializer::SerializeDelta(FNetSerializationContext& context, const FNetSerializeDeltaArgs& args) {
+		const QuantizedType& value = *reinterpret_cast<const QuantizedType*>(args.Source);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamWriter& writer = *context.GetBitStreamWriter();
+		writer.WriteBits(value.Stat, FResourceStatModifier::StatBits);
+		writer.WriteBits(value.Operation, FResourceStatModifier::OperationBits);
+		const bool bMagnitudeChanged = value.Magnitude != prev.Magnitude;
+		writer.WriteBool(bMagnitudeChanged);
+		if (bMagnitudeChanged) {
+			writer.WriteBits(value.Magnitude, 32U);
+		}
+	}
+	void FResourceStatModifierNetSerializer::DeserializeDelta(FNetSerializationContext& context, const FNetDeserializeDeltaArgs& args) {
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		const QuantizedType& prev = *reinterpret_cast<const QuantizedType*>(args.Prev);
+		FNetBitStreamReader& reader = *context.GetBitStreamReader();
+		target.Stat = static_cast<uint8>(reader.ReadBits(FResourceStatModifier::StatBits));
+		target.Operation = static_cast<uint8>(reader.ReadBits(FResourceStatModifier::OperationBits));
+		target.Magnitude = reader.ReadBool() ? reader.ReadBits(32U) : prev.Magnitude;
+	}
+	void FResourceStatModifierNetSerializer::Quantize(FNetSerializationContext& context, const FNetQuantizeArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		QuantizedType& target = *reinterpret_cast<QuantizedType*>(args.Target);
+		FMemory::Memcpy(&target.Magnitude, &source.Magnitude, sizeof(target.Magnitude));
+		target.Stat = source.Stat.GetValue();
+		target.Operation = source.Operation.GetValue();
+	}
+	void FResourceStatModifierNetSerializer::Dequantize(FNetSerializationContext& context, const FNetDequantizeArgs& args) {
+		const QuantizedType& source = *reinterpret_cast<const QuantizedType*>(args.Source);
+		SourceType& target = *reinterpret_cast<SourceType*>(args.Target);
+		FMemory::Memcpy(&target.Magnitude, &source.Magnitude, sizeof(target.Magnitude));
+		target.Stat = static_cast<EResourceStat>(source.Stat);
+		target.Operation = static_cast<EResourceStatOperation>(source.Operation);
+		target.Id = 0;
+		target.Source = NAME_None;
+	}
+	bool FResourceStatModifierNetSerializer::IsEqual(FNetSerializationContext& context, const FNetIsEqualArgs& args) {
+		if (args.bStateIsQuantized) {
+			const QuantizedType& value0 = *reinterpret_cast<const QuantizedType*>(args.Source0);
+			const QuantizedType& value1 = *reinterpret_cast<const QuantizedType*>(args.Source1);
+			return value0.Magnitude == value1.Magnitude && value0.Stat == value1.Stat && value0.Operation == value1.Operation;
+		}
+		// The id and source are not sent, so they do not make modifiers differ.
+		const SourceType& value0 = *reinterpret_cast<const SourceType*>(args.Source0);
+		const SourceType& value1 = *reinterpret_cast<const SourceType*>(args.Source1);
+		return value0.Magnitude == value1.Magnitude && value0.Stat == value1.Stat && value0.Operation == value1.Operation;
+	}
+	bool FResourceStatModifierNetSerializer::Validate(FNetSerializationContext& context, const FNetValidateArgs& args) {
+		const SourceType& source = *reinterpret_cast<const SourceType*>(args.Source);
+		return source.Stat < RS_MAX && source.Operation <= RSO_Override && FMath::IsFinite(source.Magnitude);
+	}
+
+	static const FName PropertyNetSerializerRegistry_NAME_ResourceStatModifier("ResourceStatModifier");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceStatModifier, FResourceStatModifierNetSerializer);
+
+	FResourceStatModifierNetSerializer::FNetSerializerRegistryDelegates FResourceStatModifierNetSerializer::NetSerializerRegistryDelegates;
+
+	FResourceStatModifierNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates() {
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceStatModifier);
+	}
+	void FResourceStatModifierNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry() {
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ResourceStatModifier);
+	}
+}
+#endif
@@ -4,6 +4,7 @@
 #include "ResourceFunctionLibrary.h"
 #include "GameFramework/Actor.h"
 #include "Components/ResourceComponentBase.h"
+#include "Components/LiteResourceComponent.h"
 #include "Components/Health/HealthResource.h"
 
 UResourceComponentBase* UResourceFunctionLibrary::GetResourceFromActor(AActor* actor, FName resourceName) {
@@ -34,6 +35,19 @@ TArray<UResourceComponentBase*> UResourceFunctionLibrary::GetAllResourcesFromAct
     }
     return retVal;
 }
+ULiteResourceComponent* UResourceFunctionLibrary::GetLiteResourceFromActor(AActor* actor, FName resourceName) {
+    if (!IsValid(actor)) {
+        return nullptr;
+    }
+    for (UActorComponent* component : actor->GetComponents()) {
+        if (ULiteResourceComponent* resource = Cast<ULiteResourceComponent>(component)) {
+            if (resource->GetResourceName() == resourceName) {
+                return resource;
+            }
+        }
+    }
+    return nullptr;
+}
 TArray<UResourceComponentBase*> UResourceFunctionLibrary::GetResourceFromActors(TArray<AActor*> actors, FName resourceName) {
     TArray<UResourceComponentBase*> retVal;
     for (int i = 0; i < actors.Num(); i++) {
@@ -56,24 +70,36 @@ void UResourceFunctionLibrary::AddResourceToActor(AActor* actor, FName resourceN
     if (UResourceComponentBase* resource = GetResourceFromActor(actor)) {
         resource->K2_AddResource(addAmount);
     }
+    else if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+        lite->AddResource(addAmount);
+    }
 }
 void UResourceFunctionLibrary::DrainResourceFromActor(AActor* actor, FName resourceName, float drainAmount) {
     if (!IsValid(actor)) { return; }
     if (UResourceComponentBase* resource = GetResourceFromActor(actor)) {
         resource->K2_DrainResource(drainAmount);
     }
+    else if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+        lite->DrainResource(drainAmount);
+    }
 }
 void UResourceFunctionLibrary::AddResourcePercentToActor(AActor* actor, FName resourceName, float addPercent, EResourcePercentType percentType) {
     if (!IsValid(actor)) { return; }
     if (UResourceComponentBase* resource = GetResourceFromActor(actor)) {
         resource->K2_AddResourceByPercent(addPercent, percentType);
     }
+    else if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+        lite->AddResourceByPercent(addPercent, percentType);
+    }
 }
 void UResourceFunctionLibrary::DrainResourcePercentFromActor(AActor* actor, FName resourceName, float drainPercent, EResourcePercentType percentType) {
     if (!IsValid(actor)) { return; }
     if (UResourceComponentBase* resource = GetResourceFromActor(actor)) {
         resource->K2_DrainResourceByPercent(drainPercent, percentType);
     }
+    else if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+        lite->DrainResourceByPercent(drainPercent, percentType);
+    }
 }
 
 void UResourceFunctionLibrary::AddResourceToActors(TArray<AActor*> actors, FName resourceName, float addAmount) {
@@ -81,24 +107,52 @@ void UResourceFunctionLibrary::AddResourceToActors(TArray<AActor*> actors, FName
     for (int r = 0; r < resources.Num(); r++) {
         resources[r]->K2_AddResource(addAmount);
     }
+    for (AActor* actor : actors) {
+        if (!GetResourceFromActor(actor, resourceName)) {
+            if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+                lite->AddResource(addAmount);
+            }
+        }
+    }
 }
 void UResourceFunctionLibrary::DrainResourceFromActors(TArray<AActor*> actors, FName resourceName, float drainAmount) {
     TArray<UResourceComponentBase*> resources = GetResourceFromActors(actors, resourceName);
     for (int r = 0; r < resources.Num(); r++) {
         resources[r]->K2_DrainResource(drainAmount);
     }
+    for (AActor* actor : actors) {
+        if (!GetResourceFromActor(actor, resourceName)) {
+            if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+                lite->DrainResource(drainAmount);
+            }
+        }
+    }
 }
 void UResourceFunctionLibrary::AddResourcePercentToActors(TArray<AActor*> actors, FName resourceName, float addPercent, EResourcePercentType percentType) {
     TArray<UResourceComponentBase*> resources = GetResourceFromActors(actors, resourceName);
     for (int r = 0; r < resources.Num(); r++) {
         resources[r]->K2_AddResourceByPercent(addPercent, percentType);
     }
+    for (AActor* actor : actors) {
+        if (!GetResourceFromActor(actor, resourceName)) {
+            if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+                lite->AddResourceByPercent(addPercent, percentType);
+            }
+        }
+    }
 }
 void UResourceFunctionLibrary::DrainResourcePercentFromActors(TArray<AActor*> actors, FName resourceName, float drainPercent, EResourcePercentType percentType) {
     TArray<UResourceComponentBase*> resources = GetResourceFromActors(actors, resourceName);
     for (int r = 0; r < resources.Num(); r++) {
         resources[r]->K2_DrainResourceByPercent(drainPercent, percentType);
     }
+    for (AActor* actor : actors) {
+        if (!GetResourceFromActor(actor, resourceName)) {
+            if (ULiteResourceComponent* lite = GetLiteResourceFromActor(actor, resourceName)) {
+                lite->DrainResourceByPercent(drainPercent, percentType);
+            }
+        }
+    }
 }
 
 TArray<UHealthResource*> UResourceFunctionLibrary::GetActorHealthResources(AActor* actor, TArray<FName> healthResourceNameFilter) {
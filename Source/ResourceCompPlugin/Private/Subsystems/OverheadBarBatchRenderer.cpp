@@ -0,0 +1,135 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/OverheadBarBatchRenderer.h"
+#include "CanvasItem.h"
+#include "Engine/Canvas.h"
+#include "Engine/World.h"
+#include "GameFramework/HUD.h"
+#include "RenderUtils.h"
+#include "Subsystems/OverheadBarManager.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+UOverheadBarBatchRenderer* UOverheadBarBatchRenderer::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UOverheadBarBatchRenderer>() : nullptr;
+}
+
+void UOverheadBarBatchRenderer::Register(UHealthResourceWithUI* resource) {
+	if (!IsValid(resource) || GetWorld()->GetNetMode() == NM_DedicatedServer || Resources.Contains(resource)) {
+		return;
+	}
+	FOverheadBarSource& source = Sources.AddDefaulted_GetRef();
+	source.Resource = resource;
+	source.Owner = resource->GetOwner();
+	source.Offset = resource->WidgetOffset.GetLocation();
+	source.StyleId = InternStyle(resource->BatchedBarStyle);
+	Resources.Add(resource);
+}
+void UOverheadBarBatchRenderer::Unregister(UHealthResourceWithUI* resource) {
+	const int32 index = Resources.IndexOfByKey(resource);
+	if (index != INDEX_NONE) {
+		Resources.RemoveAtSwap(index, 1, EAllowShrinking::No);
+		Sources.RemoveAtSwap(index, 1, EAllowShrinking::No);
+	}
+}
+
+void UOverheadBarBatchRenderer::BuildInstances(TConstArrayView<FOverheadBarSource> sources, const FVector& viewLocation, const FVector& viewDirection,
+	float maxDistance, bool bRequireRendered, TArray<FOverheadBarInstance>& outInstances) {
+	const double maxDistanceSquared = static_cast<double>(maxDistance) * maxDistance;
+	for (const FOverheadBarSource& source : sources) {
+		if (source.bHidden) {
+			continue;
+		}
+		const FVector position = (source.Owner ? source.Owner->GetActorLocation() : FVector::ZeroVector) + source.Offset;
+		const FVector toBar = position - viewLocation;
+		if (toBar.SizeSquared() > maxDistanceSquared || (toBar | viewDirection) <= 0) {
+			continue;
+		}
+		if (bRequireRendered && source.Owner && !source.Owner->WasRecentlyRendered(0.2f)) {
+			continue;
+		}
+		FOverheadBarInstance& instance = outInstances.AddUninitialized_GetRef();
+		instance.WorldPosition = position;
+		instance.Percent = FMath::Clamp(source.Resource->GetCurrentPercent(), 0.f, 1.f);
+		instance.StyleId = source.StyleId;
+	}
+}
+
+bool UOverheadBarBatchRenderer::ShouldCreateSubsystem(UObject* Outer) const {
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+void UOverheadBarBatchRenderer::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+	PostRenderHandle = AHUD::OnHUDPostRender.AddUObject(this, &UOverheadBarBatchRenderer::DrawInstances);
+}
+void UOverheadBarBatchRenderer::Deinitialize() {
+	AHUD::OnHUDPostRender.Remove(PostRenderHandle);
+	Resources.Reset();
+	Sources.Reset();
+	Instances.Reset();
+	Super::Deinitialize();
+}
+void UOverheadBarBatchRenderer::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	Instances.Reset();
+	const APlayerController* viewer = GetWorld()->GetFirstPlayerController();
+	for (int32 r = Resources.Num() - 1; r >= 0; r--) {
+		const UHealthResourceWithUI* resource = Resources[r].Get();
+		if (!resource || !IsValid(resource->GetOwner())) {
+			Resources.RemoveAtSwap(r, 1, EAllowShrinking::No);
+			Sources.RemoveAtSwap(r, 1, EAllowShrinking::No);
+			continue;
+		}
+		Sources[r].bHidden = !resource->ShouldShowOverheadTo(viewer);
+	}
+	if (!IsValid(viewer)) {
+		return;
+	}
+	FVector viewLocation;
+	FRotator viewRotation;
+	viewer->GetPlayerViewPoint(viewLocation, viewRotation);
+	BuildInstances(Sources, viewLocation, viewRotation.Vector(), UOverheadBarManager::GetMaxDistance(), true, Instances);
+}
+TStatId UOverheadBarBatchRenderer::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOverheadBarBatchRenderer, STATGROUP_Tickables);
+}
+
+uint8 UOverheadBarBatchRenderer::InternStyle(const FOverheadBarStyle& style) {
+	const int32 existing = Styles.IndexOfByKey(style);
+	if (existing != INDEX_NONE) {
+		return static_cast<uint8>(existing);
+	}
+	if (Styles.Num() > MAX_uint8) {
+		// Out of IDs. Share the first style rather than drawing nothing.
+		return 0;
+	}
+	return static_cast<uint8>(Styles.Add(style));
+}
+void UOverheadBarBatchRenderer::DrawInstances(AHUD* hud, UCanvas* canvas) {
+	if (Instances.IsEmpty() || !IsValid(hud) || hud->GetWorld() != GetWorld() || !IsValid(canvas)) {
+		return;
+	}
+	ScreenPositions.SetNumUninitialized(Instances.Num(), EAllowShrinking::No);
+	for (int32 i = 0; i < Instances.Num(); i++) {
+		ScreenPositions[i] = canvas->Project(Instances[i].WorldPosition);
+	}
+	// All backgrounds, then all fills. Every tile uses the white texture and the same blend mode,
+	// so the canvas keeps them in one batch.
+	for (int32 pass = 0; pass < 2; pass++) {
+		for (int32 i = 0; i < Instances.Num(); i++) {
+			if (ScreenPositions[i].Z <= 0) {
+				continue;
+			}
+			const FOverheadBarStyle& style = Styles[Instances[i].StyleId];
+			const FVector2D topLeft(ScreenPositions[i].X - style.Size.X * 0.5, ScreenPositions[i].Y - style.Size.Y * 0.5);
+			const FVector2D size = pass == 0 ? style.Size : FVector2D(style.Size.X * Instances[i].Percent, style.Size.Y);
+			FCanvasTileItem tile(topLeft, GWhiteTexture, size, pass == 0 ? style.BackgroundColor : style.FillColor);
+			tile.BlendMode = SE_BLEND_Translucent;
+			canvas->DrawItem(tile);
+		}
+	}
+}
@@ -0,0 +1,265 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/OverheadBarManager.h"
+#include "Components/Health/HealthResourceWithUI.h"
+#include "Components/WidgetComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<int32> CVarOverheadBarPoolSize(
+	TEXT("ResourceComp.OverheadBars.PoolSize"),
+	32,
+	TEXT("Maximum number of pooled overhead bars shown at once."));
+static TAutoConsoleVariable<float> CVarOverheadBarMaxDistance(
+	TEXT("ResourceComp.OverheadBars.MaxDistance"),
+	5000.f,
+	TEXT("Pooled overhead bars are only shown for actors within this distance of the local view."));
+static TAutoConsoleVariable<float> CVarOverheadBarRecentDamageTime(
+	TEXT("ResourceComp.OverheadBars.RecentDamageTime"),
+	3.f,
+	TEXT("Seconds after a drain during which an actor is ranked ahead of undamaged actors at a similar distance."));
+
+// Recently damaged actors are ranked as if they were this much closer.
+static constexpr float RecentDamageDistanceScale = 0.25f;
+
+UOverheadBarManager* UOverheadBarManager::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UOverheadBarManager>() : nullptr;
+}
+
+float UOverheadBarManager::GetMaxDistance() {
+	return CVarOverheadBarMaxDistance.GetValueOnGameThread();
+}
+float UOverheadBarManager::GetRecentDamageTime() {
+	return CVarOverheadBarRecentDamageTime.GetValueOnGameThread();
+}
+
+void UOverheadBarManager::Register(UHealthResourceWithUI* resource) {
+	if (!IsValid(resource) || GetWorld()->GetNetMode() == NM_DedicatedServer) {
+		return;
+	}
+	const TObjectKey<UHealthResourceWithUI> key(resource);
+	if (RegisteredIndices.Contains(key)) {
+		return;
+	}
+	FRegisteredBar& bar = Registered.AddDefaulted_GetRef();
+	bar.Resource = resource;
+	bar.Key = key;
+	bar.DrainHandle = resource->OnNativeEvent(RET_Drain).AddWeakLambda(this, [this, key](float) {
+		if (const int32* index = RegisteredIndices.Find(key)) {
+			Registered[*index].LastDamageTime = GetWorld()->GetTimeSeconds();
+		}
+	});
+	RegisteredIndices.Add(key, Registered.Num() - 1);
+}
+void UOverheadBarManager::Unregister(UHealthResourceWithUI* resource) {
+	const int32* index = RegisteredIndices.Find(TObjectKey<UHealthResourceWithUI>(resource));
+	if (!index) {
+		return;
+	}
+	if (IsValid(resource)) {
+		resource->OnNativeEvent(RET_Drain).Remove(Registered[*index].DrainHandle);
+	}
+	RemoveRegisteredAt(*index);
+}
+
+bool UOverheadBarManager::ShouldCreateSubsystem(UObject* Outer) const {
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+void UOverheadBarManager::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	UWorld* world = GetWorld();
+	const int32 poolSize = FMath::Max(0, CVarOverheadBarPoolSize.GetValueOnGameThread());
+
+	// The pool shrinks immediately when the size is lowered.
+	for (int32 p = Pool.Num() - 1; p >= poolSize; p--) {
+		if (PoolAssignments[p] != INDEX_NONE) {
+			ReleaseBar(PoolAssignments[p]);
+		}
+		if (IsValid(Pool[p])) {
+			Pool[p]->DestroyComponent();
+		}
+		Pool.RemoveAt(p, 1, EAllowShrinking::No);
+		PoolAssignments.RemoveAt(p, 1, EAllowShrinking::No);
+	}
+
+	APlayerController* viewer = world->GetFirstPlayerController();
+	FVector viewLocation = FVector::ZeroVector;
+	FRotator viewRotation;
+	if (IsValid(viewer)) {
+		viewer->GetPlayerViewPoint(viewLocation, viewRotation);
+	}
+	const double now = world->GetTimeSeconds();
+	const float maxDistance = GetMaxDistance();
+
+	for (int32 r = Registered.Num() - 1; r >= 0; r--) {
+		if (!Registered[r].Resource.IsValid()) {
+			RemoveRegisteredAt(r);
+		}
+	}
+	Candidates.Reset();
+	for (int32 r = 0; r < Registered.Num() && IsValid(viewer); r++) {
+		const float score = ScoreResource(Registered[r], viewLocation, now, maxDistance * maxDistance);
+		if (score >= 0) {
+			Candidates.Emplace(score, r);
+		}
+	}
+	if (Candidates.Num() > poolSize) {
+		Candidates.Sort([](const TPair<float, int32>& a, const TPair<float, int32>& b) { return a.Key < b.Key; });
+		Candidates.SetNum(poolSize, EAllowShrinking::No);
+	}
+
+	Selected.Init(false, Registered.Num());
+	for (const TPair<float, int32>& candidate : Candidates) {
+		Selected[candidate.Value] = true;
+	}
+	// Release first, so their bars can go to newly selected resources this frame.
+	for (int32 r = 0; r < Registered.Num(); r++) {
+		if (Registered[r].PoolIndex != INDEX_NONE && !Selected[r]) {
+			ReleaseBar(r);
+		}
+	}
+	for (const TPair<float, int32>& candidate : Candidates) {
+		FRegisteredBar& bar = Registered[candidate.Value];
+		if (bar.PoolIndex != INDEX_NONE) {
+			continue;
+		}
+		UHealthResourceWithUI* resource = bar.Resource.Get();
+		const int32 poolIndex = AcquireBar(*resource);
+		if (poolIndex == INDEX_NONE) {
+			break;
+		}
+		PoolAssignments[poolIndex] = candidate.Value;
+		bar.PoolIndex = poolIndex;
+		NumAssigned++;
+		ConfigureBar(*Pool[poolIndex], *resource);
+	}
+
+	for (int32 p = 0; p < Pool.Num(); p++) {
+		if (PoolAssignments[p] == INDEX_NONE) {
+			continue;
+		}
+		const UHealthResourceWithUI* resource = Registered[PoolAssignments[p]].Resource.Get();
+		const FTransform& offset = resource->WidgetOffset;
+		Pool[p]->SetWorldLocationAndRotation(resource->GetOwner()->GetActorLocation() + offset.GetLocation(), offset.GetRotation());
+	}
+}
+TStatId UOverheadBarManager::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOverheadBarManager, STATGROUP_Tickables);
+}
+void UOverheadBarManager::Deinitialize() {
+	for (FRegisteredBar& bar : Registered) {
+		if (UHealthResourceWithUI* resource = bar.Resource.Get()) {
+			resource->OnNativeEvent(RET_Drain).Remove(bar.DrainHandle);
+		}
+	}
+	Registered.Reset();
+	RegisteredIndices.Reset();
+	Pool.Reset();
+	PoolAssignments.Reset();
+	NumAssigned = 0;
+	if (IsValid(PoolOwner)) {
+		PoolOwner->Destroy();
+	}
+	PoolOwner = nullptr;
+	Super::Deinitialize();
+}
+
+float UOverheadBarManager::ScoreResource(const FRegisteredBar& bar, const FVector& viewLocation, double now, float maxDistanceSquared) const {
+	const UHealthResourceWithUI* resource = bar.Resource.Get();
+	const AActor* owner = resource->GetOwner();
+	if (!IsValid(owner) || owner->IsHidden() || !resource->OverheadWidgetClass.Get()
+		|| !resource->ShouldShowOverheadTo(GetWorld()->GetFirstPlayerController())) {
+		return -1.f;
+	}
+	const float distanceSquared = FVector::DistSquared(viewLocation, owner->GetActorLocation());
+	if (distanceSquared > maxDistanceSquared || !owner->WasRecentlyRendered(0.2f)) {
+		return -1.f;
+	}
+	const bool bRecentlyDamaged = bar.LastDamageTime >= 0 && now - bar.LastDamageTime <= CVarOverheadBarRecentDamageTime.GetValueOnGameThread();
+	return FMath::Sqrt(distanceSquared) * (bRecentlyDamaged ? RecentDamageDistanceScale : 1.f);
+}
+int32 UOverheadBarManager::AcquireBar(const UHealthResourceWithUI& resource) {
+	int32 freeIndex = INDEX_NONE;
+	for (int32 p = 0; p < Pool.Num(); p++) {
+		if (PoolAssignments[p] != INDEX_NONE) {
+			continue;
+		}
+		if (Pool[p]->GetWidgetClass() == resource.OverheadWidgetClass.Get()) {
+			return p;
+		}
+		if (freeIndex == INDEX_NONE) {
+			freeIndex = p;
+		}
+	}
+	if (freeIndex != INDEX_NONE || Pool.Num() >= CVarOverheadBarPoolSize.GetValueOnGameThread()) {
+		return freeIndex;
+	}
+
+	if (!IsValid(PoolOwner)) {
+		FActorSpawnParameters spawnParams;
+		spawnParams.ObjectFlags |= RF_Transient;
+		spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		PoolOwner = GetWorld()->SpawnActor<AActor>(spawnParams);
+		if (!IsValid(PoolOwner)) {
+			return INDEX_NONE;
+		}
+	}
+	UWidgetComponent* component = NewObject<UWidgetComponent>(PoolOwner, NAME_None, RF_Transient);
+	component->SetUsingAbsoluteLocation(true);
+	component->SetUsingAbsoluteRotation(true);
+	component->SetUsingAbsoluteScale(true);
+	component->SetComponentTickEnabled(false);
+	component->SetVisibility(false);
+	component->RegisterComponent();
+	PoolAssignments.Add(INDEX_NONE);
+	return Pool.Add(component);
+}
+void UOverheadBarManager::ReleaseBar(int32 registeredIndex) {
+	FRegisteredBar& bar = Registered[registeredIndex];
+	if (bar.PoolIndex == INDEX_NONE) {
+		return;
+	}
+	if (IsValid(Pool[bar.PoolIndex])) {
+		Pool[bar.PoolIndex]->SetVisibility(false);
+	}
+	PoolAssignments[bar.PoolIndex] = INDEX_NONE;
+	bar.PoolIndex = INDEX_NONE;
+	NumAssigned--;
+}
+void UOverheadBarManager::ConfigureBar(UWidgetComponent& component, UHealthResourceWithUI& resource) const {
+	component.SetWidgetSpace(resource.bUseWorldSpace ? EWidgetSpace::World : EWidgetSpace::Screen);
+	component.SetDrawAtDesiredSize(resource.bDrawAtDesiredSize);
+	component.SetDrawSize(resource.DrawSize);
+	component.SetMaterial(0, resource.OverheadWidgetMaterial.Get());
+	if (component.GetWidgetClass() != resource.OverheadWidgetClass.Get()) {
+		component.SetWidgetClass(resource.OverheadWidgetClass.Get());
+	}
+	if (!component.GetWidget()) {
+		component.InitWidget();
+	}
+	if (APlayerController* viewer = GetWorld()->GetFirstPlayerController()) {
+		component.SetOwnerPlayer(viewer->GetLocalPlayer());
+	}
+	UHealthResourceWithUI::SetWidgetResource(component.GetWidget(), &resource);
+	component.SetVisibility(true);
+}
+void UOverheadBarManager::RemoveRegisteredAt(int32 index) {
+	ReleaseBar(index);
+	RegisteredIndices.Remove(Registered[index].Key);
+	const int32 lastIndex = Registered.Num() - 1;
+	if (index != lastIndex) {
+		// The last entry moves into the hole.
+		const FRegisteredBar& moved = Registered[lastIndex];
+		RegisteredIndices.Add(moved.Key, index);
+		if (moved.PoolIndex != INDEX_NONE) {
+			PoolAssignments[moved.PoolIndex] = index;
+		}
+	}
+	Registered.RemoveAtSwap(index, 1, EAllowShrinking::No);
+}
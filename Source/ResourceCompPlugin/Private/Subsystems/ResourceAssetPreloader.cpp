@@ -0,0 +1,45 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceAssetPreloader.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+
+UResourceAssetPreloader* UResourceAssetPreloader::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceAssetPreloader>() : nullptr;
+}
+
+void UResourceAssetPreloader::Request(const FSoftObjectPath& path) {
+	if (path.IsNull() || Handles.Contains(path)) {
+		return;
+	}
+	// Kept even if the asset is already loaded, so it stays resident for the world's lifetime.
+	Handles.Add(path, UAssetManager::GetStreamableManager().RequestAsyncLoad(path));
+}
+UObject* UResourceAssetPreloader::Resolve(const FSoftObjectPath& path) {
+	if (path.IsNull()) {
+		return nullptr;
+	}
+	Request(path);
+	const TSharedPtr<FStreamableHandle>& handle = Handles.FindChecked(path);
+	if (handle.IsValid() && handle->IsLoadingInProgress()) {
+		handle->WaitUntilComplete();
+	}
+	return path.ResolveObject();
+}
+
+bool UResourceAssetPreloader::ShouldCreateSubsystem(UObject* Outer) const {
+	const UWorld* world = Cast<UWorld>(Outer);
+	return IsValid(world) && world->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+void UResourceAssetPreloader::Deinitialize() {
+	for (TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& handle : Handles) {
+		if (handle.Value.IsValid()) {
+			handle.Value->ReleaseHandle();
+		}
+	}
+	Handles.Reset();
+	Super::Deinitialize();
+}
@@ -0,0 +1,178 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceCommandSubsystem.h"
+#include "Components/ResourceComponentBase.h"
+#include "Components/Health/HealthResource.h"
+#include "Core/ResourceCoreUtils.h"
+#include "Interfaces/DamageTypeModificationInterface.h"
+
+#include "Async/ParallelFor.h"
+
+//MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+
+void UResourceCommandSubsystem::Enqueue(FResourceCommand&& command) {
+	Queue.Enqueue(MoveTemp(command));
+}
+void UResourceCommandSubsystem::EnqueueAdd(UResourceComponentBase* target, float amount, uint64 sortKey) {
+	FResourceCommand command;
+	command.Target = target;
+	command.Type = EResourceCommandType::Add;
+	command.Amount = amount;
+	command.SortKey = sortKey;
+	Enqueue(MoveTemp(command));
+}
+void UResourceCommandSubsystem::EnqueueDrain(UResourceComponentBase* target, float amount, uint64 sortKey) {
+	FResourceCommand command;
+	command.Target = target;
+	command.Type = EResourceCommandType::Drain;
+	command.Amount = amount;
+	command.SortKey = sortKey;
+	Enqueue(MoveTemp(command));
+}
+void UResourceCommandSubsystem::EnqueueDamage(UHealthResource* target, float damage, uint64 sortKey, EIncomingDamageChannel channel, const UDamageType* damageType,
+	FVector damageOrigin, FName boneName, AActor* damageCauser, AController* instigatedBy) {
+	FResourceCommand command;
+	command.Target = target;
+	command.Type = EResourceCommandType::Damage;
+	command.Amount = damage;
+	command.SortKey = sortKey;
+	command.DamageChannel = channel;
+	command.DamageType = damageType;
+	command.BoneName = boneName;
+	command.DamageOrigin = damageOrigin;
+	command.HitLocation = damageOrigin;
+	command.DamageCauser = damageCauser;
+	command.InstigatedBy = instigatedBy;
+	Enqueue(MoveTemp(command));
+}
+
+void UResourceCommandSubsystem::Flush() {
+	check(IsInGameThread());
+
+	Pending.Reset();
+	FResourceCommand command;
+	while (Queue.Dequeue(command)) {
+		Pending.Add(MoveTemp(command));
+	}
+	if (Pending.Num() == 0) {
+		return;
+	}
+
+	/* Deterministic order */ {
+		// Keeps queue order for the target grouping below.
+		Pending.RemoveAll([](const FResourceCommand& c) {
+			const UResourceComponentBase* target = c.Target.Get();
+			return !IsValid(target) || !IsValid(target->GetOwner()) || !target->GetOwner()->HasAuthority();
+		});
+		// Object ids and queue arrival differ between processes, so targets are ordered by path name instead.
+		TargetOrders.Reset();
+		TargetPaths.Reset();
+		for (const FResourceCommand& c : Pending) {
+			const TObjectKey<UResourceComponentBase> key(c.Target.Get());
+			if (!TargetOrders.Contains(key)) {
+				TargetOrders.Add(key, 0);
+				TargetPaths.Emplace(c.Target->GetPathName(), key);
+			}
+		}
+		TargetPaths.Sort([](const TPair<FString, TObjectKey<UResourceComponentBase>>& a, const TPair<FString, TObjectKey<UResourceComponentBase>>& b) {
+			return a.Key < b.Key;
+		});
+		for (int32 i = 0; i < TargetPaths.Num(); i++) {
+			TargetOrders[TargetPaths[i].Value] = i;
+		}
+		for (FResourceCommand& c : Pending) {
+			c.TargetOrder = TargetOrders[TObjectKey<UResourceComponentBase>(c.Target.Get())];
+		}
+		// Stable, so commands with equal keys keep their queue order, which is issue order within each thread.
+		Pending.StableSort([](const FResourceCommand& a, const FResourceCommand& b) {
+			if (a.TargetOrder != b.TargetOrder) { return a.TargetOrder < b.TargetOrder; }
+			return a.SortKey < b.SortKey;
+		});
+	}
+
+	/* Modify damage in parallel over targets */ {
+		struct FTargetRange {
+			int32 First = 0;
+			int32 Num = 0;
+			const UHealthResource* Health = nullptr;
+			FVector Location = FVector::ZeroVector;
+		};
+		TArray<FTargetRange> targets;
+		for (int32 i = 0; i < Pending.Num(); i++) {
+			if (targets.Num() == 0 || Pending[targets.Last().First].Target != Pending[i].Target) {
+				FTargetRange& range = targets.AddDefaulted_GetRef();
+				range.First = i;
+				// Rules are compiled here so the parallel pass only reads them.
+				const UHealthResource* health = Cast<UHealthResource>(Pending[i].Target.Get());
+				if (IsValid(health) && health->CanModifyDamageOffGameThread()) {
+					health->UpdateCompiledRules();
+					range.Health = health;
+					range.Location = health->GetOwner()->GetActorLocation();
+				}
+			}
+			targets.Last().Num++;
+		}
+
+		ParallelFor(targets.Num(), [this, &targets](int32 index) {
+			const FTargetRange& range = targets[index];
+			if (!range.Health) {
+				return;
+			}
+			// The damage type interface may run Blueprint. Those commands are left for the commit pass.
+			ResourceCore::FDamageTypeOps ops = ResourceCore::MakeDamageTypeOps(nullptr);
+			ops.ModifyFromDamageType = nullptr;
+			for (int32 i = range.First; i < range.First + range.Num; i++) {
+				FResourceCommand& c = Pending[i];
+				if (c.Type != EResourceCommandType::Damage
+					|| (c.DamageType && c.DamageType->GetClass()->ImplementsInterface(UDamageTypeModificationInterface::StaticClass()))) {
+					continue;
+				}
+				ResourceCore::FDamageQuery query;
+				query.Damage = c.Amount;
+				query.Channel = ResourceCore::ToCoreChannel(c.DamageChannel);
+				query.DamageType = ResourceCore::MakeTypeId(c.DamageType);
+				query.Bone = ResourceCore::MakeNameId(c.BoneName);
+				query.Distance = (c.DamageOrigin - range.Location).Length();
+				c.ModifiedAmount = ResourceCore::ModifyDamage(range.Health->GetActiveCompiledRules(), query, ops);
+				c.bModified = true;
+			}
+		});
+	}
+
+	/* Commit */
+	for (FResourceCommand& c : Pending) {
+		// An earlier command's delegates may have destroyed the target.
+		UResourceComponentBase* target = c.Target.Get();
+		if (!IsValid(target)) {
+			continue;
+		}
+		switch (c.Type) {
+		case EResourceCommandType::Add:
+			target->K2_AddResource(c.Amount);
+			break;
+		case EResourceCommandType::Drain:
+			target->K2_DrainResource(c.Amount);
+			break;
+		case EResourceCommandType::Damage:
+			if (UHealthResource* health = Cast<UHealthResource>(target)) {
+				const float damage = c.bModified ? c.ModifiedAmount : health->ModifyDamage(c.Amount, c.DamageChannel, c.DamageType, c.BoneName, c.DamageOrigin);
+				health->ApplyModifiedDamage(damage, c.DamageChannel, c.DamageType, c.BoneName, c.DamageOrigin, c.HitLocation, c.InstigatedBy.Get(), c.DamageCauser.Get());
+			}
+			break;
+		}
+	}
+	Pending.Reset();
+}
+
+void UResourceCommandSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	Flush();
+}
+
+TStatId UResourceCommandSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceCommandSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,70 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceEventSubsystem.h"
+#include "Engine/World.h"
+
+UResourceEventSubsystem* UResourceEventSubsystem::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceEventSubsystem>() : nullptr;
+}
+
+FDelegateHandle UResourceEventSubsystem::Subscribe(EResourceEventType type, FOnResourceBusEvent::FDelegate&& delegate) {
+	if (type >= RET_MAX) {
+		return FDelegateHandle();
+	}
+	return Subscribers[type].Add(MoveTemp(delegate));
+}
+void UResourceEventSubsystem::Unsubscribe(EResourceEventType type, FDelegateHandle handle) {
+	if (type < RET_MAX) {
+		Subscribers[type].Remove(handle);
+	}
+}
+void UResourceEventSubsystem::UnsubscribeAll(const void* userObject) {
+	for (FOnResourceBusEvent& subscribers : Subscribers) {
+		subscribers.RemoveAll(userObject);
+	}
+}
+
+void UResourceEventSubsystem::QueueEvents(UResourceComponentBase* resource, uint32 events, float value) {
+	int32& index = PendingIndices.FindOrAdd(resource, INDEX_NONE);
+	if (index == INDEX_NONE) {
+		index = Pending.AddDefaulted();
+		Pending[index].Resource = resource;
+	}
+	FPendingEvents& pending = Pending[index];
+	pending.Events |= events;
+	UResourceComponentBase::ForEachEventType(events, [&pending, value](EResourceEventType type) {
+		pending.Values[type] = value;
+	});
+}
+
+void UResourceEventSubsystem::Flush() {
+	if (Pending.Num() == 0) {
+		return;
+	}
+	// Swap first so listeners that change resources queue into next frame's batch.
+	Swap(Pending, Dispatching);
+	PendingIndices.Reset();
+
+	for (const FPendingEvents& pending : Dispatching) {
+		UResourceComponentBase::ForEachEventType(pending.Events, [this, &pending](EResourceEventType type) {
+			UResourceComponentBase* resource = pending.Resource.Get();
+			if (!IsValid(resource)) {
+				return;
+			}
+			resource->BroadcastEvent(type, pending.Values[type]);
+			Subscribers[type].Broadcast(resource, pending.Values[type]);
+		});
+	}
+	Dispatching.Reset();
+}
+
+void UResourceEventSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	Flush();
+}
+
+TStatId UResourceEventSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceEventSubsystem, STATGROUP_Tickables);
+}
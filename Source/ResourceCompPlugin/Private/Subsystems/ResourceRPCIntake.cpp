@@ -0,0 +1,173 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceRPCIntake.h"
+#include "Components/ResourceComponentBase.h"
+#include "ResourceCompPlugin.h"
+
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+
+static TAutoConsoleVariable<float> CVarRPCIntakeRate(
+	TEXT("ResourceComp.RPCIntake.Rate"),
+	30.f,
+	TEXT("Resource requests per second each client connection may send before requests are dropped."));
+static TAutoConsoleVariable<float> CVarRPCIntakeBurst(
+	TEXT("ResourceComp.RPCIntake.Burst"),
+	60.f,
+	TEXT("Resource requests a client connection may send at once after being idle."));
+
+namespace ResourceRPCIntake {
+	static FAutoConsoleCommand StatsCommand(
+		TEXT("ResourceComp.RPCIntake.Stats"),
+		TEXT("Logs the accepted, merged and dropped resource requests of every server world. Pass 1 to reset the counters afterwards."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+			if (!GEngine) {
+				return;
+			}
+			const bool bReset = args.IsValidIndex(0) && FCString::Atoi(*args[0]) != 0;
+			for (const FWorldContext& context : GEngine->GetWorldContexts()) {
+				UWorld* world = context.World();
+				if (!IsValid(world) || !world->IsGameWorld() || world->GetNetMode() == NM_Client) {
+					continue;
+				}
+				if (UResourceRPCIntake* intake = world->GetSubsystem<UResourceRPCIntake>()) {
+					intake->LogCounters();
+					if (bReset) {
+						intake->ResetCounters();
+					}
+				}
+			}
+		}));
+}
+
+UResourceRPCIntake* UResourceRPCIntake::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceRPCIntake>() : nullptr;
+}
+
+void UResourceRPCIntake::SubmitAmount(UResourceComponentBase* resource, float amountDelta) {
+	if (FResourceIntakeRequests* requests = Admit(resource)) {
+		if (requests->AmountSteps.Num() > 0 && (requests->AmountSteps.Last() >= 0) == (amountDelta >= 0)) {
+			requests->AmountSteps.Last() += amountDelta;
+		}
+		else {
+			requests->AmountSteps.Add(amountDelta);
+		}
+	}
+}
+void UResourceRPCIntake::SubmitDrainTime(UResourceComponentBase* resource, float drainTime) {
+	if (FResourceIntakeRequests* requests = Admit(resource)) {
+		requests->DrainTime = drainTime;
+		requests->bHasDrainTime = true;
+	}
+}
+void UResourceRPCIntake::SubmitWidgetSettings(UResourceComponentBase* resource, bool bUseOnscreen, uint8 overheadVisibility) {
+	if (FResourceIntakeRequests* requests = Admit(resource)) {
+		requests->bUseOnscreen = bUseOnscreen;
+		requests->OverheadVisibility = overheadVisibility;
+		requests->bHasWidgetSettings = true;
+	}
+}
+
+FResourceIntakeRequests* UResourceRPCIntake::Admit(UResourceComponentBase* resource) {
+	const AActor* owner = IsValid(resource) ? resource->GetOwner() : nullptr;
+	if (!IsValid(owner)) {
+		return nullptr;
+	}
+	FResourceIntakeCounters* connectionCounters = nullptr;
+	if (!TryConsumeToken(owner->GetNetConnection(), connectionCounters)) {
+		Counters.Dropped++;
+		if (connectionCounters) {
+			connectionCounters->Dropped++;
+		}
+		return nullptr;
+	}
+	Counters.Accepted++;
+	if (connectionCounters) {
+		connectionCounters->Accepted++;
+	}
+	const TObjectKey<UResourceComponentBase> key(resource);
+	if (const int32* index = PendingIndices.Find(key)) {
+		Counters.Merged++;
+		if (connectionCounters) {
+			connectionCounters->Merged++;
+		}
+		return &Pending[*index].Requests;
+	}
+	PendingIndices.Add(key, Pending.Num());
+	FPendingBatch& batch = Pending.AddDefaulted_GetRef();
+	batch.Resource = resource;
+	return &batch.Requests;
+}
+bool UResourceRPCIntake::TryConsumeToken(UNetConnection* connection, FResourceIntakeCounters*& outConnectionCounters) {
+	if (!connection) {
+		return true;
+	}
+	const float burst = FMath::Max(1.f, CVarRPCIntakeBurst.GetValueOnGameThread());
+	const double now = GetWorld()->GetRealTimeSeconds();
+	FTokenBucket& bucket = Buckets.FindOrAdd(TObjectKey<UNetConnection>(connection));
+	if (bucket.LastRefillTime < 0) {
+		bucket.Tokens = burst;
+		bucket.ConnectionName = connection->GetName();
+	}
+	else {
+		const float rate = FMath::Max(0.f, CVarRPCIntakeRate.GetValueOnGameThread());
+		bucket.Tokens = FMath::Min(burst, bucket.Tokens + static_cast<float>(now - bucket.LastRefillTime) * rate);
+	}
+	bucket.LastRefillTime = now;
+	outConnectionCounters = &bucket.Counters;
+	if (bucket.Tokens < 1.f) {
+		return false;
+	}
+	bucket.Tokens -= 1.f;
+	return true;
+}
+
+void UResourceRPCIntake::Flush() {
+	// Applying can call back into the intake, e.g. through a listener, so new requests wait for the next flush.
+	TArray<FPendingBatch> batches = MoveTemp(Pending);
+	Pending.Reset();
+	PendingIndices.Reset();
+	for (const FPendingBatch& batch : batches) {
+		if (UResourceComponentBase* resource = batch.Resource.Get()) {
+			resource->ApplyIntakeRequests(batch.Requests);
+			Counters.Applied++;
+		}
+	}
+	// Forget closed connections.
+	for (auto it = Buckets.CreateIterator(); it; ++it) {
+		if (!it.Key().ResolveObjectPtr()) {
+			it.RemoveCurrent();
+		}
+	}
+}
+void UResourceRPCIntake::ResetCounters() {
+	Counters = FResourceIntakeCounters();
+	for (TPair<TObjectKey<UNetConnection>, FTokenBucket>& bucket : Buckets) {
+		bucket.Value.Counters = FResourceIntakeCounters();
+	}
+}
+void UResourceRPCIntake::LogCounters() const {
+	const FString worldName = GetWorld()->GetDebugDisplayName();
+	UE_LOG(LogResourceComp, Log, TEXT("RPCIntake [%s]: %lld accepted, %lld merged, %lld dropped, %lld batches applied"),
+		*worldName, Counters.Accepted, Counters.Merged, Counters.Dropped, Counters.Applied);
+	for (const TPair<TObjectKey<UNetConnection>, FTokenBucket>& bucket : Buckets) {
+		const FResourceIntakeCounters& counters = bucket.Value.Counters;
+		UE_LOG(LogResourceComp, Log, TEXT("RPCIntake [%s]   %s: %lld accepted, %lld merged, %lld dropped, %.1f tokens"),
+			*worldName, *bucket.Value.ConnectionName, counters.Accepted, counters.Merged, counters.Dropped, bucket.Value.Tokens);
+	}
+}
+
+void UResourceRPCIntake::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	Flush();
+}
+TStatId UResourceRPCIntake::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceRPCIntake, STATGROUP_Tickables);
+}
@@ -0,0 +1,97 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceSimulationLOD.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<float> CVarSimLODUpdateInterval(
+	TEXT("ResourceComp.SimLOD.UpdateInterval"),
+	0.5f,
+	TEXT("Seconds between simulation LOD updates."));
+static TAutoConsoleVariable<float> CVarSimLODReducedDistance(
+	TEXT("ResourceComp.SimLOD.ReducedDistance"),
+	3000.f,
+	TEXT("Resources farther than this from every player's view are simulated at Reduced."));
+static TAutoConsoleVariable<float> CVarSimLODDormantDistance(
+	TEXT("ResourceComp.SimLOD.DormantDistance"),
+	10000.f,
+	TEXT("Resources farther than this from every player's view are Dormant."));
+static TAutoConsoleVariable<float> CVarSimLODReducedRegenInterval(
+	TEXT("ResourceComp.SimLOD.ReducedRegenInterval"),
+	1.f,
+	TEXT("Seconds between regen catch-ups for resources at Reduced. Takes effect as regen is rescheduled."));
+
+UResourceSimulationLOD* UResourceSimulationLOD::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceSimulationLOD>() : nullptr;
+}
+float UResourceSimulationLOD::GetReducedRegenInterval() {
+	return FMath::Max(0.01f, CVarSimLODReducedRegenInterval.GetValueOnGameThread());
+}
+EResourceSimulationLOD UResourceSimulationLOD::GetLODForDistance(float distance) {
+	if (distance > CVarSimLODDormantDistance.GetValueOnGameThread()) {
+		return RSL_Dormant;
+	}
+	return distance > CVarSimLODReducedDistance.GetValueOnGameThread() ? RSL_Reduced : RSL_Full;
+}
+
+void UResourceSimulationLOD::Register(UResourceComponentBase* resource) {
+	if (IsValid(resource)) {
+		Registered.AddUnique(resource);
+	}
+}
+void UResourceSimulationLOD::Unregister(UResourceComponentBase* resource) {
+	Registered.RemoveSwap(resource, EAllowShrinking::No);
+}
+
+void UResourceSimulationLOD::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0) {
+		return;
+	}
+	TimeUntilUpdate = FMath::Max(0.f, CVarSimLODUpdateInterval.GetValueOnGameThread());
+
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it) {
+		if (const APlayerController* playerController = it->Get()) {
+			FVector viewLocation;
+			FRotator viewRotation;
+			playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+			ViewLocations.Add(viewLocation);
+		}
+	}
+
+	Registered.RemoveAllSwap([](const TWeakObjectPtr<UResourceComponentBase>& resource) { return !resource.IsValid(); }, EAllowShrinking::No);
+	// Changing a LOD can broadcast events whose listeners end play and unregister, so iterate a copy.
+	UpdateList = Registered;
+	for (const TWeakObjectPtr<UResourceComponentBase>& weakResource : UpdateList) {
+		UResourceComponentBase* resource = weakResource.Get();
+		if (!IsValid(resource)) {
+			continue;
+		}
+		resource->SetSimulationLOD(Resolver.IsBound() ? Resolver.Execute(resource) : GetDefaultLOD(*resource));
+	}
+	UpdateList.Reset();
+}
+TStatId UResourceSimulationLOD::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceSimulationLOD, STATGROUP_Tickables);
+}
+
+EResourceSimulationLOD UResourceSimulationLOD::GetDefaultLOD(const UResourceComponentBase& resource) const {
+	const AActor* owner = resource.GetOwner();
+	if (!IsValid(owner) || ViewLocations.IsEmpty()) {
+		return RSL_Full;
+	}
+	const FVector location = owner->GetActorLocation();
+	float nearestDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& viewLocation : ViewLocations) {
+		nearestDistanceSquared = FMath::Min(nearestDistanceSquared, static_cast<float>(FVector::DistSquared(viewLocation, location)));
+	}
+	return GetLODForDistance(FMath::Sqrt(nearestDistanceSquared));
+}
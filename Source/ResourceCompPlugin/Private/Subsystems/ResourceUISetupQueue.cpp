@@ -0,0 +1,67 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceUISetupQueue.h"
+#include "Components/Health/HealthResourceWithUI.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<float> CVarUISetupBudgetUs(
+	TEXT("ResourceComp.UI.SetupBudgetUs"),
+	500.f,
+	TEXT("Microseconds per frame spent creating queued overhead widgets. 0 or less creates them immediately."));
+
+UResourceUISetupQueue* UResourceUISetupQueue::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceUISetupQueue>() : nullptr;
+}
+bool UResourceUISetupQueue::IsEnabled() {
+	return CVarUISetupBudgetUs.GetValueOnGameThread() > 0;
+}
+
+void UResourceUISetupQueue::Enqueue(UHealthResourceWithUI* resource) {
+	if (IsValid(resource)) {
+		Pending.AddUnique(resource);
+	}
+}
+void UResourceUISetupQueue::Remove(UHealthResourceWithUI* resource) {
+	Pending.RemoveSwap(resource, EAllowShrinking::No);
+}
+
+bool UResourceUISetupQueue::ShouldCreateSubsystem(UObject* Outer) const {
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+void UResourceUISetupQueue::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	Pending.RemoveAllSwap([](const TWeakObjectPtr<UHealthResourceWithUI>& resource) {
+		return !resource.IsValid() || !IsValid(resource->GetOwner());
+	}, EAllowShrinking::No);
+	if (Pending.IsEmpty()) {
+		return;
+	}
+
+	// Nearest last, so they can be popped.
+	if (const APlayerController* viewer = GetWorld()->GetFirstPlayerController()) {
+		FVector viewLocation;
+		FRotator viewRotation;
+		viewer->GetPlayerViewPoint(viewLocation, viewRotation);
+		Pending.Sort([&viewLocation](const TWeakObjectPtr<UHealthResourceWithUI>& a, const TWeakObjectPtr<UHealthResourceWithUI>& b) {
+			return FVector::DistSquared(viewLocation, a->GetOwner()->GetActorLocation()) > FVector::DistSquared(viewLocation, b->GetOwner()->GetActorLocation());
+		});
+	}
+
+	const double budgetSeconds = CVarUISetupBudgetUs.GetValueOnGameThread() * 1e-6;
+	const double start = FPlatformTime::Seconds();
+	do {
+		UHealthResourceWithUI* resource = Pending.Pop(EAllowShrinking::No).Get();
+		resource->RunQueuedUISetup();
+	} while (Pending.Num() > 0 && FPlatformTime::Seconds() - start < budgetSeconds);
+}
+TStatId UResourceUISetupQueue::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceUISetupQueue, STATGROUP_Tickables);
+}
@@ -0,0 +1,167 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceUISignificance.h"
+#include "Subsystems/OverheadBarManager.h"
+#include "Components/Health/HealthResourceWithUI.h"
+#include "Components/WidgetComponent.h"
+#include "Widgets/ResourceWidgetBase.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// MP Reqs
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<int32> CVarUIFullRateBars(
+	TEXT("ResourceComp.UI.FullRateBars"),
+	16,
+	TEXT("Number of the most significant overhead widgets that update every frame. Negative means all."));
+static TAutoConsoleVariable<float> CVarUIReducedUpdateInterval(
+	TEXT("ResourceComp.UI.ReducedUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between updates for visible overhead widgets outside the full rate budget."));
+static TAutoConsoleVariable<float> CVarUISignificanceInterval(
+	TEXT("ResourceComp.UI.SignificanceInterval"),
+	0.1f,
+	TEXT("Seconds between rankings of overhead widgets by significance."));
+
+// Recently damaged actors are ranked as if they were this much closer, like pooled bars.
+static constexpr float RecentDamageDistanceScale = 0.25f;
+
+UResourceUISignificance* UResourceUISignificance::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceUISignificance>() : nullptr;
+}
+
+void UResourceUISignificance::Register(UHealthResourceWithUI* resource) {
+	if (!IsValid(resource)) {
+		return;
+	}
+	const TObjectKey<UHealthResourceWithUI> key(resource);
+	if (TrackedIndices.Contains(key)) {
+		return;
+	}
+	FTrackedResource& tracked = Tracked.AddDefaulted_GetRef();
+	tracked.Resource = resource;
+	tracked.Key = key;
+	tracked.DrainHandle = resource->OnNativeEvent(RET_Drain).AddWeakLambda(this, [this, key](float) {
+		if (const int32* index = TrackedIndices.Find(key)) {
+			FTrackedResource& damaged = Tracked[*index];
+			damaged.LastDamageTime = GetWorld()->GetTimeSeconds();
+			// A damaged widget that is visible goes to full rate right away rather than at the next ranking.
+			if (damaged.Tier == ETier::Reduced) {
+				ApplyTier(damaged, ETier::Full, 0.f);
+			}
+		}
+	});
+	TrackedIndices.Add(key, Tracked.Num() - 1);
+}
+void UResourceUISignificance::Unregister(UHealthResourceWithUI* resource) {
+	const int32* index = TrackedIndices.Find(TObjectKey<UHealthResourceWithUI>(resource));
+	if (!index) {
+		return;
+	}
+	if (IsValid(resource)) {
+		resource->OnNativeEvent(RET_Drain).Remove(Tracked[*index].DrainHandle);
+	}
+	RemoveTrackedAt(*index);
+}
+
+bool UResourceUISignificance::ShouldCreateSubsystem(UObject* Outer) const {
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+void UResourceUISignificance::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0) {
+		return;
+	}
+	TimeUntilUpdate = FMath::Max(0.f, CVarUISignificanceInterval.GetValueOnGameThread());
+
+	for (int32 t = Tracked.Num() - 1; t >= 0; t--) {
+		if (!Tracked[t].Resource.IsValid()) {
+			RemoveTrackedAt(t);
+		}
+	}
+
+	UWorld* world = GetWorld();
+	APlayerController* viewer = world->GetFirstPlayerController();
+	FVector viewLocation = FVector::ZeroVector;
+	FRotator viewRotation;
+	if (IsValid(viewer)) {
+		viewer->GetPlayerViewPoint(viewLocation, viewRotation);
+	}
+	const double now = world->GetTimeSeconds();
+	const float maxDistance = UOverheadBarManager::GetMaxDistance();
+	const float maxDistanceSquared = maxDistance * maxDistance;
+	const float recentDamageTime = UOverheadBarManager::GetRecentDamageTime();
+	const float reducedInterval = FMath::Max(0.f, CVarUIReducedUpdateInterval.GetValueOnGameThread());
+
+	Candidates.Reset();
+	for (int32 t = 0; t < Tracked.Num(); t++) {
+		FTrackedResource& tracked = Tracked[t];
+		const UHealthResourceWithUI* resource = tracked.Resource.Get();
+		const AActor* owner = resource->GetOwner();
+		const UWidgetComponent* component = resource->OverheadWidgetComponent;
+		float distanceSquared = -1.f;
+		if (IsValid(viewer) && IsValid(owner) && !owner->IsHidden() && IsValid(component) && component->IsVisible()
+			&& resource->ShouldShowOverheadTo(viewer) && owner->WasRecentlyRendered(0.2f)) {
+			distanceSquared = FVector::DistSquared(viewLocation, owner->GetActorLocation());
+		}
+		if (distanceSquared < 0 || distanceSquared > maxDistanceSquared) {
+			ApplyTier(tracked, ETier::Hidden, reducedInterval);
+			continue;
+		}
+		const bool bRecentlyDamaged = tracked.LastDamageTime >= 0 && now - tracked.LastDamageTime <= recentDamageTime;
+		Candidates.Emplace(bRecentlyDamaged ? distanceSquared * RecentDamageDistanceScale * RecentDamageDistanceScale : distanceSquared, t);
+	}
+
+	int32 fullRateBars = CVarUIFullRateBars.GetValueOnGameThread();
+	if (fullRateBars < 0) {
+		fullRateBars = Candidates.Num();
+	}
+	if (Candidates.Num() > fullRateBars) {
+		Candidates.Sort([](const TPair<float, int32>& a, const TPair<float, int32>& b) { return a.Key < b.Key; });
+	}
+	for (int32 c = 0; c < Candidates.Num(); c++) {
+		ApplyTier(Tracked[Candidates[c].Value], c < fullRateBars ? ETier::Full : ETier::Reduced, reducedInterval);
+	}
+}
+TStatId UResourceUISignificance::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceUISignificance, STATGROUP_Tickables);
+}
+void UResourceUISignificance::Deinitialize() {
+	for (FTrackedResource& tracked : Tracked) {
+		if (UHealthResourceWithUI* resource = tracked.Resource.Get()) {
+			resource->OnNativeEvent(RET_Drain).Remove(tracked.DrainHandle);
+		}
+	}
+	Tracked.Reset();
+	TrackedIndices.Reset();
+	Super::Deinitialize();
+}
+
+void UResourceUISignificance::ApplyTier(FTrackedResource& tracked, ETier tier, float reducedInterval) {
+	const float interval = tier == ETier::Full ? 0.f : reducedInterval;
+	if (tracked.Tier == tier && tracked.AppliedInterval == interval) {
+		return;
+	}
+	tracked.Tier = tier;
+	tracked.AppliedInterval = interval;
+	UHealthResourceWithUI* resource = tracked.Resource.Get();
+	if (UWidgetComponent* component = resource->OverheadWidgetComponent) {
+		// Only affects world space widgets, which are drawn to a render target.
+		component->SetRedrawTime(interval);
+	}
+	if (UResourceWidgetBase* widget = Cast<UResourceWidgetBase>(resource->OverheadWidget)) {
+		widget->SetUpdateThrottle(interval, tier != ETier::Hidden);
+	}
+}
+void UResourceUISignificance::RemoveTrackedAt(int32 index) {
+	TrackedIndices.Remove(Tracked[index].Key);
+	Tracked.RemoveAtSwap(index, 1, EAllowShrinking::No);
+	if (Tracked.IsValidIndex(index)) {
+		TrackedIndices[Tracked[index].Key] = index;
+	}
+}
@@ -0,0 +1,216 @@
+// Copyright LyCH. 2024
+
+
+#include "Subsystems/ResourceWorldStore.h"
+#include "Components/ResourceComponentBase.h"
+#include "Engine/World.h"
+
+UResourceWorldStore* UResourceWorldStore::Get(const UObject* worldContext) {
+	const UWorld* world = IsValid(worldContext) ? worldContext->GetWorld() : nullptr;
+	return IsValid(world) ? world->GetSubsystem<UResourceWorldStore>() : nullptr;
+}
+
+FResourceStoreHandle UResourceWorldStore::Register(UResourceComponentBase* resource, float currentAmount, float maxAmount, const ResourceCore::FRegenParams& params) {
+	const int32 denseIndex = CurrentAmounts.AddUninitialized();
+	MaxAmounts.AddUninitialized();
+	RegenAmounts.AddUninitialized();
+	RegenRates.AddUninitialized();
+	RegenDelays.AddUninitialized();
+	AdditionalExhaustedDelays.AddUninitialized();
+	bRegenAfterDepletion.AddUninitialized();
+	TimesAtLastDrain.Add(0.0);
+	NextRegenTimes.Add(-1.0);
+	bFirstRegenTick.Add(false);
+	Resources.Add(resource);
+
+	int32 sparseIndex = INDEX_NONE;
+	if (FreeSparse.Num() > 0) {
+		sparseIndex = FreeSparse.Pop(EAllowShrinking::No);
+	}
+	else {
+		sparseIndex = SparseToDense.Add(INDEX_NONE);
+		Generations.Add(0);
+	}
+	SparseToDense[sparseIndex] = denseIndex;
+	DenseToSparse.Add(sparseIndex);
+
+	const FResourceStoreHandle handle = MakeHandle(denseIndex);
+	SetValues(handle, currentAmount, maxAmount, params);
+	return handle;
+}
+void UResourceWorldStore::Unregister(FResourceStoreHandle& handle) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	handle.Reset();
+	if (denseIndex == INDEX_NONE) {
+		return;
+	}
+	const int32 sparseIndex = DenseToSparse[denseIndex];
+	const int32 lastIndex = CurrentAmounts.Num() - 1;
+	// The last entry moves into the hole, so only its indirection changes.
+	SparseToDense[DenseToSparse[lastIndex]] = denseIndex;
+	CurrentAmounts.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	MaxAmounts.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	RegenAmounts.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	RegenRates.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	RegenDelays.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	AdditionalExhaustedDelays.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	TimesAtLastDrain.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	NextRegenTimes.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	bRegenAfterDepletion.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	bFirstRegenTick.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	Resources.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+	DenseToSparse.RemoveAtSwap(denseIndex, 1, EAllowShrinking::No);
+
+	SparseToDense[sparseIndex] = INDEX_NONE;
+	Generations[sparseIndex]++;
+	FreeSparse.Add(sparseIndex);
+}
+
+uint32 UResourceWorldStore::Add(const FResourceStoreHandle& handle, float amount) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	if (denseIndex == INDEX_NONE) {
+		return ResourceCore::Event_None;
+	}
+	ResourceCore::FResourceState state = GatherState(denseIndex);
+	const uint32 events = ResourceCore::Add(state, amount, GetNow(), GatherParams(denseIndex));
+	ScatterState(denseIndex, state);
+	return events;
+}
+uint32 UResourceWorldStore::Drain(const FResourceStoreHandle& handle, float amount) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	if (denseIndex == INDEX_NONE) {
+		return ResourceCore::Event_None;
+	}
+	ResourceCore::FResourceState state = GatherState(denseIndex);
+	const uint32 events = ResourceCore::Drain(state, amount, GetNow(), GatherParams(denseIndex));
+	ScatterState(denseIndex, state);
+	return events;
+}
+void UResourceWorldStore::SetValues(const FResourceStoreHandle& handle, float currentAmount, float maxAmount, const ResourceCore::FRegenParams& params) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	if (denseIndex == INDEX_NONE) {
+		return;
+	}
+	CurrentAmounts[denseIndex] = currentAmount;
+	MaxAmounts[denseIndex] = maxAmount;
+	RegenAmounts[denseIndex] = params.Amount;
+	RegenRates[denseIndex] = params.Rate;
+	RegenDelays[denseIndex] = params.Delay;
+	AdditionalExhaustedDelays[denseIndex] = params.AdditionalExhaustedDelay;
+	bRegenAfterDepletion[denseIndex] = params.bRegenAfterDepletion;
+}
+void UResourceWorldStore::ScheduleRegen(const FResourceStoreHandle& handle, float initialDelay) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	if (denseIndex == INDEX_NONE) {
+		return;
+	}
+	ResourceCore::FResourceState state = GatherState(denseIndex);
+	const ResourceCore::FRegenParams params = GatherParams(denseIndex);
+	if (initialDelay < 0 || !ResourceCore::ShouldRegen(state.Current, params)) {
+		ResourceCore::RestartRegen(state, GetNow(), params);
+	}
+	else if (state.NextRegenTime < 0) {
+		state.NextRegenTime = GetNow() + initialDelay;
+		state.bFirstRegenTick = true;
+	}
+	ScatterState(denseIndex, state);
+}
+void UResourceWorldStore::SetSchedule(const FResourceStoreHandle& handle, double timeAtLastDrain, double nextRegenTime, bool bFirstTick) {
+	const int32 denseIndex = GetDenseIndex(handle);
+	if (denseIndex == INDEX_NONE) {
+		return;
+	}
+	TimesAtLastDrain[denseIndex] = timeAtLastDrain;
+	NextRegenTimes[denseIndex] = nextRegenTime;
+	bFirstRegenTick[denseIndex] = bFirstTick;
+}
+float UResourceWorldStore::GetCurrentAmount(const FResourceStoreHandle& handle) const {
+	const int32 denseIndex = GetDenseIndex(handle);
+	return denseIndex != INDEX_NONE ? CurrentAmounts[denseIndex] : 0.f;
+}
+
+void UResourceWorldStore::GetPercents(TArray<float>& outPercents) const {
+	const int32 num = CurrentAmounts.Num();
+	outPercents.SetNumUninitialized(num);
+	const float* current = CurrentAmounts.GetData();
+	const float* maximum = MaxAmounts.GetData();
+	float* percents = outPercents.GetData();
+	for (int32 i = 0; i < num; i++) {
+		percents[i] = maximum[i] > 0 ? current[i] / maximum[i] : 0.f;
+	}
+}
+void UResourceWorldStore::AdvanceRegen(double now) {
+	// Find what is due in one linear scan first. Components are only notified afterwards, because their
+	// listeners may add, drain or unregister entries, which reorders the arrays.
+	DueScratch.Reset();
+	const int32 num = NextRegenTimes.Num();
+	const double* nextRegenTimes = NextRegenTimes.GetData();
+	for (int32 i = 0; i < num; i++) {
+		if (nextRegenTimes[i] >= 0 && nextRegenTimes[i] <= now) {
+			DueScratch.Add(MakeHandle(i));
+		}
+	}
+	for (const FResourceStoreHandle& handle : DueScratch) {
+		const int32 denseIndex = GetDenseIndex(handle);
+		if (denseIndex == INDEX_NONE) {
+			continue;
+		}
+		ResourceCore::FResourceState state = GatherState(denseIndex);
+		const float oldAmount = state.Current;
+		const uint32 events = ResourceCore::AdvanceRegen(state, now, GatherParams(denseIndex));
+		ScatterState(denseIndex, state);
+		if (UResourceComponentBase* resource = Resources[denseIndex].Get()) {
+			resource->ApplyWorldStoreEvents(oldAmount, events);
+		}
+	}
+}
+
+void UResourceWorldStore::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+	if (Num() > 0) {
+		AdvanceRegen(GetNow());
+	}
+}
+TStatId UResourceWorldStore::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UResourceWorldStore, STATGROUP_Tickables);
+}
+
+int32 UResourceWorldStore::GetDenseIndex(const FResourceStoreHandle& handle) const {
+	if (!SparseToDense.IsValidIndex(handle.Index) || Generations[handle.Index] != handle.Generation) {
+		return INDEX_NONE;
+	}
+	return SparseToDense[handle.Index];
+}
+FResourceStoreHandle UResourceWorldStore::MakeHandle(int32 denseIndex) const {
+	FResourceStoreHandle handle;
+	handle.Index = DenseToSparse[denseIndex];
+	handle.Generation = Generations[handle.Index];
+	return handle;
+}
+ResourceCore::FResourceState UResourceWorldStore::GatherState(int32 denseIndex) const {
+	ResourceCore::FResourceState state;
+	state.Current = CurrentAmounts[denseIndex];
+	state.Max = MaxAmounts[denseIndex];
+	state.TimeAtLastDrain = TimesAtLastDrain[denseIndex];
+	state.NextRegenTime = NextRegenTimes[denseIndex];
+	state.bFirstRegenTick = bFirstRegenTick[denseIndex] != 0;
+	return state;
+}
+ResourceCore::FRegenParams UResourceWorldStore::GatherParams(int32 denseIndex) const {
+	ResourceCore::FRegenParams params;
+	params.Amount = RegenAmounts[denseIndex];
+	params.Rate = RegenRates[denseIndex];
+	params.Delay = RegenDelays[denseIndex];
+	params.AdditionalExhaustedDelay = AdditionalExhaustedDelays[denseIndex];
+	params.bRegenAfterDepletion = bRegenAfterDepletion[denseIndex] != 0;
+	return params;
+}
+void UResourceWorldStore::ScatterState(int32 denseIndex, const ResourceCore::FResourceState& state) {
+	CurrentAmounts[denseIndex] = state.Current;
+	TimesAtLastDrain[denseIndex] = state.TimeAtLastDrain;
+	NextRegenTimes[denseIndex] = state.NextRegenTime;
+	bFirstRegenTick[denseIndex] = state.bFirstRegenTick;
+}
+double UResourceWorldStore::GetNow() const {
+	return GetWorld()->GetTimeSeconds();
+}
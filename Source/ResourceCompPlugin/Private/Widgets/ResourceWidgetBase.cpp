@@ -0,0 +1,88 @@
+// Copyright LyCH. 2024
+
+
+#include "Widgets/ResourceWidgetBase.h"
+
+// Event flags are one bit per event type, so they can be shown as an EResourceEventType bitmask in Blueprint.
+static_assert(ResourceCore::Event_Changed == 1 << RET_CurrentAmountChange && ResourceCore::Event_Drained == 1 << RET_Drain
+	&& ResourceCore::Event_Added == 1 << RET_Add && ResourceCore::Event_Emptied == 1 << RET_Empty && ResourceCore::Event_Filled == 1 << RET_Fill
+	&& ResourceCore::Event_RegenStart == 1 << RET_RegenStart && ResourceCore::Event_RegenTick == 1 << RET_RegenTick
+	&& ResourceCore::Event_RegenEnd == 1 << RET_RegenEnd, "EResourceEventType must match the ResourceCore event flags.");
+
+static constexpr uint32 DamageEvents = ResourceCore::Event_Drained | ResourceCore::Event_Emptied;
+
+void UResourceWidgetBase::BindResource(UResourceComponentBase* resource) {
+	if (Resource.Get() == resource && IsValid(resource)) {
+		return;
+	}
+	UnbindResource();
+	if (IsValid(resource)) {
+		Resource = resource;
+		for (int32 type = 0; type < RET_MAX; type++) {
+			const uint32 flag = 1u << type;
+			EventHandles[type] = resource->OnNativeEvent(static_cast<EResourceEventType>(type)).AddWeakLambda(this, [this, flag](float) {
+				PendingEvents |= flag;
+			});
+		}
+		TargetPercent = resource->GetCurrentPercent();
+		DisplayedPercent = TargetPercent;
+	}
+	PendingEvents = 0;
+	TimeSinceUpdate = 0.f;
+	NativeOnResourceBound(resource);
+}
+
+void UResourceWidgetBase::SetUpdateThrottle(float minInterval, bool bDeliverRegen) {
+	ThrottleInterval = FMath::Max(0.f, minInterval);
+	bThrottleRegen = !bDeliverRegen;
+}
+
+void UResourceWidgetBase::NativeOnResourceBound(UResourceComponentBase* resource) {
+	OnResourceBound(resource);
+}
+void UResourceWidgetBase::NativeOnResourceUpdated(float percent, float delta, uint32 eventFlags) {
+	OnResourceUpdated(percent, delta, static_cast<int32>(eventFlags));
+}
+
+void UResourceWidgetBase::NativeTick(const FGeometry& MyGeometry, float InDeltaTime) {
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	TimeSinceUpdate += InDeltaTime;
+	if (PendingEvents != 0) {
+		// Damage flashes skip the throttle.
+		if ((PendingEvents & DamageEvents) != 0 || (!bThrottleRegen && TimeSinceUpdate >= FMath::Max(UpdateInterval, ThrottleInterval))) {
+			FlushUpdate();
+		}
+	}
+	DisplayedPercent = InterpSpeed > 0 ? FMath::FInterpTo(DisplayedPercent, TargetPercent, InDeltaTime, InterpSpeed) : TargetPercent;
+}
+void UResourceWidgetBase::NativeDestruct() {
+	UnbindResource();
+	Super::NativeDestruct();
+}
+
+void UResourceWidgetBase::UnbindResource() {
+	if (UResourceComponentBase* resource = Resource.Get()) {
+		for (int32 type = 0; type < RET_MAX; type++) {
+			resource->OnNativeEvent(static_cast<EResourceEventType>(type)).Remove(EventHandles[type]);
+		}
+	}
+	for (FDelegateHandle& handle : EventHandles) {
+		handle.Reset();
+	}
+	Resource.Reset();
+}
+void UResourceWidgetBase::FlushUpdate() {
+	const UResourceComponentBase* resource = Resource.Get();
+	if (!IsValid(resource)) {
+		PendingEvents = 0;
+		return;
+	}
+	const float percent = resource->GetCurrentPercent();
+	const float delta = percent - TargetPercent;
+	const uint32 events = PendingEvents;
+	TargetPercent = percent;
+	PendingEvents = 0;
+	TimeSinceUpdate = 0.f;
+	NativeOnResourceUpdated(percent, delta, events);
+}
@@ -0,0 +1,29 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ResourceCombatSimCommandlet.generated.h"
+
+/**
+ * Headless, faster than realtime combat simulation for tuning modification data and regen.
+ * Every engagement is an attacker with a fixed damage profile against a target using the plugin's resource and
+ * modification rules (ResourceCore), stepped at a fixed time step until the target empties or MaxTime runs out.
+ * Engagements are independent and run across all cores. The result is a time-to-kill distribution.
+ *
+ * Usage:
+ *   -run=ResourceCombatSim -Modifications=/Game/Data/DA_Armor,/Game/Data/DA_Headshots
+ *   Target:   -MaxAmount=100 -RegenAmount=5 -RegenRate=5 -RegenDelay=1 -AdditionalExhaustedDelay=0 -RegenAfterDepletion
+ *   Attacker: -Damage=10 -HitsPerSecond=2 -Variance=0.1 -Accuracy=1 -Channel=Point|Radial|Generic -Bone=head -BoneChance=0
+ *             -Distance=500 -DamageType=/Script/Engine.DamageType
+ *   Run:      -Engagements=1000000 -TimeStep=0.05 -MaxTime=120 -Seed=1 -BucketSize=0.25 -Output=TTK.csv
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceCombatSimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UResourceCombatSimCommandlet();
+	virtual int32 Main(const FString& Params) override;
+};
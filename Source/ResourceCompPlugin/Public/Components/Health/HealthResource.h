@@ -7,12 +7,39 @@
 #include "Data/DamageModificationData.h"
 #include "HealthResource.generated.h"
 
+struct FResourceSharedRules;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FOnGenericDamageTakenSignature, AActor*, DamagedActor, float, Damage, const UDamageType*, DamageType, AController*, InstigatedBy, AActor*, DamageCauser);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_NineParams(FOnPointDamageTakenSignature, AActor*, DamagedActor, float, Damage, AController*, InstigatedBy, FVector, HitLocation, UPrimitiveComponent*, HitComponent, FName, BoneName, FVector, ShotFromDirection, const UDamageType*, DamageType, AActor*, DamageCauser);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_SevenParams(FOnRadialDamageTakenSignature, AActor*, DamagedActor, float, Damage, const UDamageType*, DamageType, FVector, Origin, const FHitResult&, HitInfo, AController*, InstigatedBy, AActor*, DamageCauser);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FModificationSignature, const FIncomingDamageModification&, modification);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FModificationDataSignature, const UDamageModificationData*, modification);
 
+/**
+ * Everything the three damage delegates carry, in one struct for the native delegate.
+ * Fields that do not apply to the channel are left at their defaults.
+ */
+struct FResourceDamageEvent {
+	AActor* DamagedActor = nullptr;
+	float Damage = 0.f;
+	EIncomingDamageChannel Channel = EIncomingDamageChannel::GenericDamage;
+	const UDamageType* DamageType = nullptr;
+	AController* InstigatedBy = nullptr;
+	AActor* DamageCauser = nullptr;
+	// Point
+	FVector HitLocation = FVector::ZeroVector;
+	UPrimitiveComponent* HitComponent = nullptr;
+	FName BoneName;
+	FVector ShotFromDirection = FVector::ZeroVector;
+	// Radial
+	FVector Origin = FVector::ZeroVector;
+	// Points at the caller's hit, which can be a temporary. Only valid during the broadcast: copy the FHitResult to keep it.
+	const FHitResult* HitInfo = nullptr;
+};
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnResourceDamageNative, const FResourceDamageEvent& /*damageEvent*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnModificationNative, const FIncomingDamageModification& /*modification*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnModificationDataNative, const UDamageModificationData* /*modification*/);
+
 /**
  * 
  */
@@ -20,22 +47,34 @@ UCLASS(Blueprintable, BlueprintType, ClassGroup = (Resource), meta = (BlueprintS
 class RESOURCECOMPPLUGIN_API UHealthResource : public UResourceComponentBase
 {
 	GENERATED_BODY()
+	// Evaluates CompiledRules off the game thread and falls back to ModifyDamage.
+	friend class UResourceCommandSubsystem;
+	// Fills rules directly to measure memory without a world.
+	friend struct FResourceMemoryReport;
 protected:
 	/**
 	 * How long debug messages last.
 	 *///UPROPERTY()//BlueprintReadOnly, Category = "Health", meta = (EditCondition = "bDebug", EditConditionHides))
 	float DebugShowtime = 1.f;
 	/**
-	 * A data asset that will be added on BeginPlay.
-	 * If any were added to the initial ModificationRules array, these will be added afterwards.
+	 * A data asset that will be added on BeginPlay. Only the server loads it, once per world through
+	 * UResourceAssetPreloader, starting when the component registers.
+	 * If any were added to the initial ModificationRules array, these will be added afterwards. While the archetype's
+	 * rules are shared, it is merged into them instead, and resources with the same archetype and data share the result.
 	 */UPROPERTY(EditAnywhere, Category = "Health|Modifications")
-	TObjectPtr<UDamageModificationData> DefaultModificationData;
+	TSoftObjectPtr<UDamageModificationData> DefaultModificationData;
 	/**
 	 * Modifications that will be considered when receiving damage.
 	 * These modifications will be executed in array order.
 	 * Override_Health skips all other modifications.
-	 */UPROPERTY(Replicated, EditAnywhere, Category = "Health|Modifications", meta = (TitleProperty = "ModificationName"))
+	 * Change it at runtime through GetMutableModificationRules so the compiled rules are rebuilt.
+	 */UPROPERTY(ReplicatedUsing = OnRep_ModificationRules, EditAnywhere, Category = "Health|Modifications", meta = (TitleProperty = "ModificationName"))
 	TArray<FIncomingDamageModification> ModificationRules;
+	/**
+	 * If true, ModificationRules and the modification events only replicate to the owning client, whatever the
+	 * replication policy. Other clients do not evaluate damage, so disable this only if they display the rules.
+	 */UPROPERTY(EditAnywhere, Category = "Health|Modifications")
+	bool bModificationRulesOwnerOnly = true;
 	/**
 	 * Last Actor that damaged owner.
 	 */UPROPERTY(Replicated, BlueprintReadWrite, Category = "Health|Damage")
@@ -53,6 +92,34 @@ private:
 	 * This is used so damage is not taken twice. (Such as Point damage + Any damage)
 	 */
 	bool bBlockDamage = false;
+	/**
+	 * ModificationRules converted for ResourceCore. Rebuilt on the next ModifyDamage after bCompiledRulesDirty is set,
+	 * which every change to ModificationRules must do.
+	 */
+	mutable std::vector<ResourceCore::FModificationRule> CompiledRules;
+	mutable bool bCompiledRulesDirty = true;
+	/**
+	 * Below Full simulation LOD, the steps of the active rules for each channel and damage type hit so far.
+	 * Cleared when the rules are recompiled and when the resource returns to Full.
+	 */
+	struct FCachedDamageSteps {
+		std::vector<ResourceCore::FDamageStep> Steps;
+		// False if the rules depend on the bone or distance for this kind of hit.
+		bool bCacheable = false;
+	};
+	mutable TMap<TPair<uint8, ResourceCore::FTypeId>, FCachedDamageSteps> DamageStepCache;
+	/**
+	 * True while the rules are the archetype's shared array. ModificationRules stays empty until the first change copies them.
+	 */UPROPERTY(Replicated)
+	bool bUsesArchetypeRules = false;
+	/**
+	 * While bUsesArchetypeRules is set, the default modification data merged into the archetype's shared rules.
+	 */UPROPERTY(Replicated)
+	TObjectPtr<UDamageModificationData> ArchetypeRulesData;
+	/**
+	 * The archetype's rules in use, set by UpdateCompiledRules so they can be read off the game thread.
+	 */
+	mutable const FResourceSharedRules* ArchetypeRules = nullptr;
 /////////////////////////
 //////////// FUNCTIONS //
 /////////////////////////
@@ -60,8 +127,14 @@ private:
 #pragma region Overrides
 protected:
 	UHealthResource();
+	virtual void OnRegister() override;
 	virtual void BeginPlay() override;
 	virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+	/**
+	 * ModificationRules for editing, with the compiled rules marked for a rebuild. Stops sharing the archetype's rules.
+	 */
+	TArray<FIncomingDamageModification>& GetMutableModificationRules();
 #pragma endregion
 #pragma region Getters
 public:
@@ -81,7 +154,7 @@ public:
 	 * Returns all current modifiers.
 	 */UFUNCTION(BlueprintCallable, Category = "Health|Modifications")
 	TArray<FIncomingDamageModification> GetCurrentModifications() const {
-		return ModificationRules;
+		return GetActiveRules();
 	}
 	/**
 	 * Returns true if this has any of the listed modifications.
@@ -115,6 +188,12 @@ public:
 	 * Called when a modification has been removed from the resource.
 	 */UPROPERTY(BlueprintAssignable, Category = "Health|Modifications")
 	FModificationSignature OnModificationRemoved;
+	/*
+	 * Native versions of the modification delegates. Only broadcast when bound.
+	 */
+	FOnModificationDataNative OnModificationDataAddedNative;
+	FOnModificationNative OnModificationAddedNative;
+	FOnModificationNative OnModificationRemovedNative;
 protected:
 	/**
 	 * Modifies the incoming damage.
@@ -143,7 +222,38 @@ public:
 	 * Removes all modifiers with this name.
 	 */UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Health|Modifications")
 	virtual void RemoveModifier(FName modifierName);
+	/**
+	 * Drains damage that has already been modified, then updates the last hit info and broadcasts the damage delegate
+	 * for the channel, the same way the damage binders do.
+	 */
+	virtual void ApplyModifiedDamage(float modifiedDamage, EIncomingDamageChannel damageChannel, const UDamageType* DamageType, FName boneName, FVector damageOrigin, FVector hitLocation, AController* InstigatedBy, AActor* DamageCauser);
+	/**
+	 * True if ModifyDamage only evaluates the compiled rules, so deferred damage commands can evaluate them in
+	 * parallel instead. Opt-in: only true for classes whose nearest native class is UHealthResource, as a native
+	 * subclass may override ModifyDamage. Such subclasses override this to return true if their ModifyDamage allows it.
+	 */
+	virtual bool CanModifyDamageOffGameThread() const;
+	/**
+	 * True if the nearest native class of this component is nativeClass. Blueprint classes cannot override ModifyDamage.
+	 */
+	bool IsNearestNativeClass(const UClass* nativeClass) const;
+	virtual void OnSimulationLODChanged(EResourceSimulationLOD oldLOD) override;
+	virtual void ApplyReplicationPolicy() override;
 private:
+	 /*
+	 * True if ModificationRules and the modification events only replicate to the owning client.
+	 */
+	 bool AreModificationRulesOwnerOnly() const;
+	 /*
+	 * Server side. Sends a modification event to the clients that receive ModificationRules.
+	 */
+	 void SendModificationDataAdded(const UDamageModificationData* modificationData);
+	 void SendModificationChanged(const FIncomingDamageModification& modification, bool bAdded);
+	 /*
+	 * Raises the modification events on this machine.
+	 */
+	 void ReceiveModificationDataAdded(const UDamageModificationData* modificationData);
+	 void ReceiveModificationChanged(const FIncomingDamageModification& modification, bool bAdded);
 	 /*
 	 * Replicates the OnModificationDataAdded delegate.
 	 */UFUNCTION(NetMulticast, Reliable)
@@ -152,6 +262,28 @@ private:
 	 * Replicates the OnModificationAdded and OnModificationRemoved delegates.
 	 */UFUNCTION(NetMulticast, Reliable)
 	 void ModificationChanged(FIncomingDamageModification modification, bool bAdded);
+	 UFUNCTION(Client, Reliable)
+	 void ModificationDataAdded_Owner(const UDamageModificationData* modificationData);
+	 UFUNCTION(Client, Reliable)
+	 void ModificationChanged_Owner(FIncomingDamageModification modification, bool bAdded);
+	 UFUNCTION()
+	 void OnRep_ModificationRules();
+	 /*
+	 * Rebuilds CompiledRules if ModificationRules changed, or picks up the archetype's shared rules.
+	 */
+	 void UpdateCompiledRules() const;
+	 /*
+	 * The rules in effect: the archetype's while they are shared, otherwise ModificationRules.
+	 */
+	 const TArray<FIncomingDamageModification>& GetActiveRules() const;
+	 /*
+	 * The compiled form of GetActiveRules. Call UpdateCompiledRules first.
+	 */
+	 const std::vector<ResourceCore::FModificationRule>& GetActiveCompiledRules() const;
+	 /*
+	 * Copies the shared archetype rules into ModificationRules before they are changed.
+	 */
+	 void DetachArchetypeRules();
 	 
 #pragma endregion
 #pragma region Damage Binders
@@ -184,6 +316,10 @@ public:
 	 * Called on Radial damage taken.
 	 */UPROPERTY(BlueprintReadOnly, BlueprintAssignable, Category = "Health")
 	FOnRadialDamageTakenSignature OnRadialDamageTaken;
+	/**
+	 * Native version of the three damage delegates. Called wherever they are, but only when bound.
+	 */
+	FOnResourceDamageNative OnDamageTakenNative;
 	/*
 	* Override to binds different damage functions.
 	* The original function bindings are: OnGenericDamageTaken, OnPointDamageTaken, OnRadialDamageTaken.
@@ -213,5 +349,9 @@ private:
 	 * Bound to Delegate FOnRadialDamageTakenSignature
 	 */UFUNCTION(NetMulticast, Reliable)
 	virtual void RadialDamageTaken(AActor* DamagedActor, float Damage, const UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, AController* InstigatedBy, AActor* DamageCauser);
+
+	void BroadcastGenericDamageNative(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+	void BroadcastPointDamageNative(AActor* DamagedActor, float Damage, AController* InstigatedBy, FVector HitLocation, UPrimitiveComponent* HitComponent, FName BoneName, FVector ShotFromDirection, const UDamageType* DamageType, AActor* DamageCauser);
+	void BroadcastRadialDamageNative(AActor* DamagedActor, float Damage, const UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, AController* InstigatedBy, AActor* DamageCauser);
 #pragma endregion
 };
@@ -5,18 +5,46 @@
 #include "CoreMinimal.h"
 #include "Components/Health/HealthResource.h"
 #include "Blueprint/UserWidget.h"
+#include "Engine/StreamableManager.h"
 #include "HealthResourceWithUI.generated.h"
 
 class UWidgetComponent;
 
 UENUM(BlueprintType)
 enum EOverheadWidgetVisibility : uint8{
-	OHWO_OverheadDisabled UMETA(Tooltip = "The Overhead widget is never shown, but is created.", DisplayName = "Overhead Disabled"),
+	OHWO_OverheadDisabled UMETA(Tooltip = "The Overhead widget is never shown, and is not created until another setting is used.", DisplayName = "Overhead Disabled"),
 	OHWO_ShowOnlyOnPossessedPlayer UMETA(Tooltip = "The Overhead widget is only shown to the owning player.", DisplayName="Show Only On Possessed Player"),
 	OHWO_ShowOnlyOnOther UMETA(Tooltip = "The Overhead widget is not shown to the owning player.", DisplayName="Show Only On Others"),
 	OHWO_ShowOnAll UMETA(Tooltip = "The Overhead widget is used on both the owning player and others.", DisplayName="Show On All")
 };
 
+UENUM(BlueprintType)
+enum EOverheadBarRenderMode : uint8 {
+	OHRM_PerActorWidget UMETA(Tooltip = "Each resource creates its own widget component on clients.", DisplayName = "Per Actor Widget"),
+	OHRM_Pooled UMETA(Tooltip = "The world's Overhead Bar Manager lends the resource a pooled widget component while it is near, visible or recently damaged.", DisplayName = "Pooled"),
+	OHRM_Batched UMETA(Tooltip = "No widget. The world's Overhead Bar Batch Renderer draws a plain bar on the HUD canvas, together with every other batched bar.", DisplayName = "Batched")
+};
+
+/*
+ * How a batched overhead bar is drawn. Bars with equal styles share a style ID.
+ */
+USTRUCT(BlueprintType)
+struct FOverheadBarStyle {
+	GENERATED_BODY()
+	/*
+	 * Size on screen, in pixels.
+	 */UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI|Overhead")
+	FVector2D Size = FVector2D(60.f, 6.f);
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI|Overhead")
+	FLinearColor FillColor = FLinearColor(0.8f, 0.05f, 0.05f);
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI|Overhead")
+	FLinearColor BackgroundColor = FLinearColor(0.f, 0.f, 0.f, 0.6f);
+
+	bool operator==(const FOverheadBarStyle& other) const {
+		return Size == other.Size && FillColor == other.FillColor && BackgroundColor == other.BackgroundColor;
+	}
+};
+
 /**
  * 
  */
@@ -27,20 +55,31 @@ class RESOURCECOMPPLUGIN_API UHealthResourceWithUI : public UHealthResource
 public:
 	/*
 	 * This controls if the OnScreenWidget is used at all. If true, it will be added to the player's screen when possessed.
-	 */UPROPERTY(Replicated, EditAnywhere, BlueprintReadOnly, Category = "UI")
+	 */UPROPERTY(ReplicatedUsing = OnRep_EnableOnscreen, EditAnywhere, BlueprintReadOnly, Category = "UI")
 	bool bEnableOnscreen= true;
 	/**
 	 * Setting for how and when to show the overhead widget.
-	 */UPROPERTY(Replicated, EditAnywhere, BlueprintReadOnly, Category = "UI")
+	 */UPROPERTY(ReplicatedUsing = OnRep_OverheadWidgetSettings, EditAnywhere, BlueprintReadOnly, Category = "UI")
 	TEnumAsByte<EOverheadWidgetVisibility> OverheadWidgetSettings = EOverheadWidgetVisibility::OHWO_ShowOnlyOnOther;
+	/**
+	 * How the overhead widget is drawn. Use Pooled for crowds, where most actors are far away or off screen.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI|Overhead")
+	TEnumAsByte<EOverheadBarRenderMode> OverheadRenderMode = EOverheadBarRenderMode::OHRM_PerActorWidget;
+	/*
+	 * The bar drawn when Overhead Render Mode is Batched. The widget settings below are not used in that mode.
+	 * With Per Actor Widget, the placeholder bar drawn until the widget exists.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "UI|Overhead", meta = (EditCondition = "OverheadRenderMode != EOverheadBarRenderMode::OHRM_Pooled"))
+	FOverheadBarStyle BatchedBarStyle;
 	/*
 	 * This class is used when creating the widget for the possessing player's UI.
+	 * Loaded asynchronously on clients; the widget is created once it arrives.
 	 */UPROPERTY(EditAnywhere, Category = "UI")
-	TSubclassOf<UUserWidget> OnScreenWidgetClass;
+	TSoftClassPtr<UUserWidget> OnScreenWidgetClass;
 	/*
 	 * This class is used for the character's overhead widget used in a WidgetComponent.
+	 * Loaded asynchronously on clients; the widget is created once it arrives.
 	 */UPROPERTY(EditAnywhere, Category = "UI")
-	TSubclassOf<UUserWidget> OverheadWidgetClass;
+	TSoftClassPtr<UUserWidget> OverheadWidgetClass;
 
 	/*
 	 * The Z Order for the OnscreenWidget. Higher values are rendered on top.
@@ -49,7 +88,7 @@ public:
 	/*
 	 * The material that will be applied to the overhead widget.
 	 */UPROPERTY(EditAnywhere, Category = "UI|Overhead")
-	TObjectPtr<UMaterialInterface> OverheadWidgetMaterial;
+	TSoftObjectPtr<UMaterialInterface> OverheadWidgetMaterial;
 	/*
 	 * The space where the widget will appear. If false, the widget will be in screen space.
 	 * See similar settings in the WidgetComponent class.
@@ -85,23 +124,80 @@ public:
 	 * Changes how the widgets are viewed.
 	 */UFUNCTION(BlueprintCallable, Category = "UI")
 	void ChangeWidgetSettings(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead);
+	/*
+	 * If OverheadWidgetSettings allows the viewer to see this resource's overhead widget.
+	 */
+	bool ShouldShowOverheadTo(const APlayerController* viewer) const;
+	/*
+	 * True while the overhead widget is waiting for its assets to load or in the UI setup queue. Until then the resource has no widget component,
+	 * and the Overhead Bar Batch Renderer draws Batched Bar Style in its place.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UI")
+	bool IsOverheadWidgetPending() const { return bOverheadSetupQueued || (UIAssetsHandle.IsValid() && UIAssetsHandle->IsLoadingInProgress()); }
+	/*
+	 * Binds a UResourceWidgetBase to the resource. Other widgets get SetResourceComponent called, if they have one.
+	 */
+	static void SetWidgetResource(UUserWidget* widget, UResourceComponentBase* resource);
 
 protected:
 	UHealthResourceWithUI();
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const;
 	virtual void TryCreateOnScreenWidget(APlayerController* owningPlayer);
 	virtual void TryCreateOverheadWidgetComponent();
+	virtual void ApplyIntakeRequests(const FResourceIntakeRequests& requests) override;
+	virtual bool CanModifyDamageOffGameThread() const override;
 	
 	TObjectPtr<APlayerController> ActivePlayerController;
 
 private:
-	UFUNCTION(Server, Reliable)
+	// Client only. Set while the per-actor widget waits in UResourceUISetupQueue.
+	bool bOverheadSetupQueued = false;
+	// Client only. Set while the batch renderer draws a placeholder for the pending per-actor widget.
+	bool bOverheadPlaceholder = false;
+
+	friend class UResourceUISetupQueue;
+	void RunQueuedUISetup();
+	/*
+	 * Registers the resource with UOverheadBarBatchRenderer, or unregisters it, so a pending widget still has a bar.
+	 */
+	void SetOverheadPlaceholder(bool bEnable);
+	/*
+	 * Queues the per-actor widget in UResourceUISetupQueue if it has to be created, or creates it if queueing is off.
+	 */
+	void QueueOverheadWidgetSetup();
+
+	// Client only. Keeps the widget classes and material loaded for as long as the component plays.
+	TSharedPtr<FStreamableHandle> UIAssetsHandle;
+	/*
+	 * Loads the widget classes and material, then calls SetupUI. Calls it right away if they are already loaded.
+	 */
+	void RequestUIAssets();
+	/*
+	 * Creates or registers the overhead bar and creates the on-screen widget for a local player.
+	 */
+	void SetupUI();
+
+	/*
+	 * Only sent when a client calls Change Widget Settings. Everything else follows the replicated settings.
+	 * Applied through UResourceRPCIntake.
+	 */
+	UFUNCTION(Server, Reliable, WithValidation)
 	void ChangeWidgetSettingsOnServer(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead);
-	UFUNCTION(NetMulticast, Reliable)
-	void UpdateOverheadWidgetVisibilityFromServer();
-	UFUNCTION(Client, Reliable)
-	void UpdateOnscreenWidgetVisibilityFromServer();
+	/*
+	 * Sets the replicated settings on the server and applies them locally, as replication does not notify the server.
+	 */
+	void SetWidgetSettings(bool bUseOnscreen, EOverheadWidgetVisibility useOverhead);
+	/*
+	 * Adds or removes the on-screen widget of a local player.
+	 */
+	UFUNCTION()
+	void OnRep_EnableOnscreen();
+	/*
+	 * Queues the overhead widget if it was disabled before, and applies the visibility.
+	 */
+	UFUNCTION()
+	void OnRep_OverheadWidgetSettings();
 	UFUNCTION()
 	void SetOverheadVisibility(EOverheadWidgetVisibility newVisibility);
 	UFUNCTION()
@@ -0,0 +1,162 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/ResourceComponentBase.h"
+#include "Core/ResourceCorePolicies.h"
+#include "LiteResourceComponent.generated.h"
+
+/*
+ * Everything that replicates for a ULiteResourceComponent: the state as of the last add or drain.
+ * Regen since then is computed from it, so a regenerating resource sends nothing.
+ */
+USTRUCT()
+struct FLiteResourceState {
+	GENERATED_BODY()
+	UPROPERTY()
+	float Amount = 100.f;
+	// Server world time of the next regen tick, or negative if regen is not scheduled.
+	UPROPERTY()
+	double NextRegenTime = -1.0;
+	UPROPERTY()
+	bool bFirstRegenTick = false;
+
+	/*
+	 * The regen time is only sent while regen is scheduled. Iris uses FLiteResourceStateNetSerializer, which sends
+	 * the same bits.
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+template<>
+struct TStructOpsTypeTraits<FLiteResourceState> : public TStructOpsTypeTraitsBase2<FLiteResourceState> {
+	enum {
+		WithNetSerializer = true
+	};
+};
+
+class ULiteResourceComponent;
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnLiteResourceChanged, ULiteResourceComponent* /*resource*/, float /*oldValue*/, float /*newValue*/);
+
+/**
+ * A minimal resource for crowds, ambient NPCs and destructibles.
+ * Add, drain and regen follow UResourceComponentBase, but regen is analytic: the current amount is computed from
+ * the last change and the synchronized server time when read, so there is no timer, no tick and no replication
+ * while regenerating. There are no modification rules, UI, Blueprint-overridable events, dynamic delegates or
+ * multicast RPCs. Listeners bind the native OnAmountChanged, which fires for adds and drains on the server and
+ * for replicated changes on clients, not for regen progress.
+ * The Resource Function Library falls back to these components when an actor has no matching UResourceComponentBase.
+ *
+ * Budget, checked by ResourceComp.Bench.Lite:
+ * - Memory: at most BudgetBytesPerInstance bytes on top of UActorComponent.
+ * - CPU: at most BudgetNanosecondsPerHit per drain with no listeners bound.
+ */
+UCLASS(BlueprintType, ClassGroup=(Resource), meta=(BlueprintSpawnableComponent) )
+class RESOURCECOMPPLUGIN_API ULiteResourceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	static constexpr int32 BudgetBytesPerInstance = 128;
+	static constexpr double BudgetNanosecondsPerHit = 100.0;
+
+	/*
+	 * Called when an add or drain changes the amount.
+	 */
+	FOnLiteResourceChanged OnAmountChanged;
+
+	ULiteResourceComponent();
+	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+
+	/*
+	 * Increases the resource by a certain amount.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Fill Increase"))
+	void AddResource(float addAmount);
+	/*
+	 * Reduces the resource by a certain amount.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Decrease Remove Subtract"))
+	void DrainResource(float drainAmount);
+	/*
+	 * Increases the resource by a percent relative to the current value or max value.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Fill Increase"))
+	void AddResourceByPercent(float addPercent, EResourcePercentType percentType);
+	/*
+	 * Reduces the resource by a percent relative to the current value or max value.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Decrease Remove Subtract"))
+	void DrainResourceByPercent(float drainPercent, EResourcePercentType percentType);
+	/*
+	 * Toggles if the resource can be drained.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource")
+	void SetCanBeDrained(bool bCanBeDrained) { bDrainDisabled = !bCanBeDrained; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	FName GetResourceName() const { return ResourceName; }
+	/*
+	 * The current amount, including regen up to now.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetCurrentAmount() const;
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetMaxAmount() const { return MaxAmount; }
+	/*
+	 * Returns a percent (0 - 1.0) available of the resource.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetCurrentPercent() const { return ResourceCore::GetPercent(GetCurrentAmount(), MaxAmount); }
+
+protected:
+	/*
+	 * The name of this resource.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	FName ResourceName = "Default";
+	/*
+	 * The maximum amount of resource.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	float MaxAmount = 100.f;
+	/*
+	 * How much resource is filled per tick.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenAmount = 5.f;
+	/*
+	 * How many ticks per second occur.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenRate = 5.f;
+	/*
+	 * The delay after draining the resource when regen begins.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenDelay = 1.f;
+	/*
+	 * This is added to RegenDelay if regen begins when CurrentAmount is 0.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float AdditionalExhaustedDelay = 0.f;
+	/*
+	 * If true, the resource begins at 0 instead of Max Amount.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	bool bRegenBeginsEmpty = false;
+	/*
+	 * If true the resource will generate even after depletion.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	bool bRegenAfterDepletion = false;
+
+private:
+	UPROPERTY(ReplicatedUsing = OnRep_State)
+	FLiteResourceState State;
+
+	// This is only used on the server. No reason for replication.
+	bool bDrainDisabled = false;
+
+	UFUNCTION()
+	void OnRep_State(const FLiteResourceState& previousState);
+
+	ResourceCore::FRegenParams GetRegenParams() const;
+	ResourceCore::FResourceState ToCoreState(const FLiteResourceState& state) const;
+	/*
+	 * The replicated state brought forward to now.
+	 */
+	ResourceCore::FResourceState GetPresentState(double now) const;
+	/*
+	 * Server world time, so clients compute the same regen as the server.
+	 */
+	double GetNow() const;
+	bool CanModify() const;
+	void Commit(const ResourceCore::FResourceState& state, float oldValue);
+};
@@ -0,0 +1,145 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/ResourceComponentBase.h"
+#include "Core/ResourceCore.h"
+#include "TimerManager.h"
+#include "MultiResourceComponent.generated.h"
+
+/*
+ * Configuration of one resource inside a UMultiResourceComponent. Mirrors the settings on UResourceComponentBase.
+ */
+USTRUCT(BlueprintType)
+struct FMultiResourceConfig {
+	GENERATED_BODY()
+	/**
+	 * The name of this resource. Resolve it to an index once with Find Resource Index.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource")
+	FName ResourceName = "Default";
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource")
+	float MaxAmount = 100.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource")
+	bool bRegenBeginsEmpty = false;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource|Regen")
+	float RegenAmount = 5.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource|Regen")
+	float RegenRate = 5.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource|Regen")
+	float RegenDelay = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource|Regen")
+	float AdditionalExhaustedDelay = 0.f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Resource|Regen")
+	bool bRegenAfterDepletion = false;
+
+	ResourceCore::FRegenParams GetRegenParams() const;
+};
+
+/*
+ * Everything that replicates for a UMultiResourceComponent.
+ */
+USTRUCT()
+struct FMultiResourceReplicatedState {
+	GENERATED_BODY()
+	// One entry per configured resource, in config order.
+	UPROPERTY()
+	TArray<float> CurrentAmounts;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnMultiResourceEvent, int32, resourceIndex, EResourceEventType, type, float, value);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnMultiResourceNativeEvent, int32 /*resourceIndex*/, EResourceEventType /*type*/, float /*value*/);
+
+/**
+ * Holds several named resources in one component, for actors that would otherwise carry one UResourceComponentBase
+ * per resource. The resources live in one contiguous array, replicate as one struct and share one regen timer,
+ * which is scheduled for the earliest pending regen tick. Add, drain and regen behave like UResourceComponentBase.
+ * Access is by index: resolve names once with Find Resource Index.
+ * Clients receive amount change events (change, drain, add, empty, fill) from replication. Regen events are server only.
+ */
+UCLASS(Blueprintable, BlueprintType, ClassGroup=(Resource), meta=(BlueprintSpawnableComponent) )
+class RESOURCECOMPPLUGIN_API UMultiResourceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	/*
+	 * Called for every event on every resource. Check resourceIndex for the resource it belongs to.
+	 */UPROPERTY(BlueprintAssignable, Category = "Resource")
+	FOnMultiResourceEvent OnResourceEvent;
+	/*
+	 * Native version of OnResourceEvent. Only broadcast when bound.
+	 */
+	FOnMultiResourceNativeEvent OnResourceEventNative;
+
+	/*
+	 * Returns the index of the named resource, or -1. Cache the result instead of calling this per access.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	int32 FindResourceIndex(FName resourceName) const;
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	int32 GetNumResources() const { return Resources.Num(); }
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	FName GetResourceName(int32 resourceIndex) const { return Resources.IsValidIndex(resourceIndex) ? Resources[resourceIndex].ResourceName : NAME_None; }
+
+	/*
+	 * Increases the resource at the index by a certain amount.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Fill Increase"))
+	void AddResource(int32 resourceIndex, float addAmount);
+	/*
+	 * Reduces the resource at the index by a certain amount.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource", meta = (KeyWords = "Decrease Remove Subtract"))
+	void DrainResource(int32 resourceIndex, float drainAmount);
+	/*
+	 * Toggles if the resource at the index can be drained.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource")
+	void SetCanBeDrained(int32 resourceIndex, bool bCanBeDrained);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetCurrentAmount(int32 resourceIndex) const {
+		return ReplicatedState.CurrentAmounts.IsValidIndex(resourceIndex) ? ReplicatedState.CurrentAmounts[resourceIndex] : 0.f;
+	}
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetMaxAmount(int32 resourceIndex) const {
+		return Resources.IsValidIndex(resourceIndex) ? Resources[resourceIndex].MaxAmount : 0.f;
+	}
+	/*
+	 * Returns a percent (0 - 1.0) available of the resource at the index.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource")
+	float GetCurrentPercent(int32 resourceIndex) const {
+		return ResourceCore::GetPercent(GetCurrentAmount(resourceIndex), GetMaxAmount(resourceIndex));
+	}
+
+protected:
+	/*
+	 * The resources held by this component. Indices follow this order.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	TArray<FMultiResourceConfig> Resources;
+
+	UMultiResourceComponent();
+	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedState)
+	FMultiResourceReplicatedState ReplicatedState;
+
+	// Server only. Parallel to Resources.
+	TArray<ResourceCore::FResourceState> States;
+	TArray<ResourceCore::FRegenParams> RegenParams;
+	// One timer for every resource, set for the earliest NextRegenTime.
+	FTimerHandle RegenTimer;
+
+	UFUNCTION()
+	void OnRep_ReplicatedState(const FMultiResourceReplicatedState& previousState);
+
+	bool HasAuthority() const;
+	double GetNow() const;
+	/*
+	 * Writes the state back to the replicated struct and broadcasts the events.
+	 */
+	void Commit(int32 resourceIndex, uint32 events);
+	void BroadcastEvents(int32 resourceIndex, uint32 events, float value);
+	void OnRegenTimer();
+	void ScheduleRegen();
+};
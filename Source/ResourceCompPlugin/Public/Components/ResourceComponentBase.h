@@ -6,8 +6,13 @@
 #include "Components/ActorComponent.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "Core/ResourceCore.h"
+#include "Subsystems/ResourceWorldStore.h"
 #include "ResourceComponentBase.generated.h"
 
+class UResourceArchetypeData;
+struct FResourceIntakeRequests;
+
 UENUM(BlueprintType)
 enum EResourcePercentType {
 	Current,
@@ -19,9 +24,157 @@ enum EHealthRegenEventType {
 	Start,
 	End
 };
+/*
+ * One entry per resource delegate. Used by the event subsystem to dispatch batched events.
+ */
+UENUM(BlueprintType)
+enum EResourceEventType : uint8 {
+	RET_CurrentAmountChange UMETA(DisplayName = "Current Amount Change"),
+	RET_Drain UMETA(DisplayName = "Drain"),
+	RET_Add UMETA(DisplayName = "Add"),
+	RET_Empty UMETA(DisplayName = "Empty"),
+	RET_Fill UMETA(DisplayName = "Fill"),
+	RET_RegenStart UMETA(DisplayName = "Regen Start"),
+	RET_RegenTick UMETA(DisplayName = "Regen Tick"),
+	RET_RegenEnd UMETA(DisplayName = "Regen End"),
+	RET_MAX UMETA(Hidden)
+};
+/*
+ * Resource values that stat modifiers can change.
+ */
+UENUM(BlueprintType)
+enum EResourceStat : uint8 {
+	RS_MaxAmount UMETA(DisplayName = "Max Amount"),
+	RS_RegenAmount UMETA(DisplayName = "Regen Amount"),
+	RS_RegenRate UMETA(DisplayName = "Regen Rate"),
+	RS_RegenDelay UMETA(DisplayName = "Regen Delay"),
+	RS_MAX UMETA(Hidden)
+};
+/*
+ * Stat modifiers are applied in layers: (Base + Flat) * (1 + Percent Add) * Multiply. An Override replaces everything.
+ */
+UENUM(BlueprintType)
+enum EResourceStatOperation : uint8 {
+	RSO_Flat UMETA(DisplayName = "Flat"),
+	RSO_PercentAdd UMETA(DisplayName = "Percent Add"),
+	RSO_Multiply UMETA(DisplayName = "Multiply"),
+	RSO_Override UMETA(DisplayName = "Override")
+};
+UENUM(BlueprintType)
+enum EResourceThresholdDirection : uint8 {
+	RTD_Falling UMETA(DisplayName = "Falling"),
+	RTD_Rising UMETA(DisplayName = "Rising"),
+	RTD_Both UMETA(DisplayName = "Both")
+};
+/*
+ * How closely the server simulates a resource. See Set Simulation LOD.
+ */
+UENUM(BlueprintType)
+enum EResourceSimulationLOD : uint8 {
+	RSL_Full UMETA(DisplayName = "Full"),
+	RSL_Reduced UMETA(DisplayName = "Reduced"),
+	RSL_Dormant UMETA(DisplayName = "Dormant")
+};
+/*
+ * Which clients receive a resource's state. See Replication Policy.
+ */
+UENUM(BlueprintType)
+enum EResourceReplicationPolicy : uint8 {
+	RRP_Everyone UMETA(DisplayName = "Everyone"),
+	RRP_OwnerFullOthersPercent UMETA(DisplayName = "Owner Full, Others Percent"),
+	RRP_OwnerOnly UMETA(DisplayName = "Owner Only")
+};
+
+USTRUCT(BlueprintType)
+struct FResourceStatModifier {
+	GENERATED_BODY()
+	static constexpr uint32 StatBits = 2;
+	static constexpr uint32 OperationBits = 2;
+	/**
+	 * Identifies the modifier for Remove Stat Modifier. Server only.
+	 */UPROPERTY(BlueprintReadOnly, Category = "Variable|Stat Modifier")
+	int32 Id = 0;
+	/**
+	 * Used to remove every modifier a buff or item applied at once. Server only.
+	 */UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variable|Stat Modifier")
+	FName Source;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variable|Stat Modifier")
+	TEnumAsByte<EResourceStat> Stat = RS_MaxAmount;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variable|Stat Modifier")
+	TEnumAsByte<EResourceStatOperation> Operation = RSO_Flat;
+	/**
+	 * Amount for Flat and Override, fraction for Percent Add (0.1 = +10%), factor for Multiply.
+	 */UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Variable|Stat Modifier")
+	float Magnitude = 0.f;
+
+	/*
+	 * Clients only aggregate modifiers, so only the stat, operation and magnitude are sent. Iris uses
+	 * FResourceStatModifierNetSerializer, which sends the same bits.
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+template<>
+struct TStructOpsTypeTraits<FResourceStatModifier> : public TStructOpsTypeTraitsBase2<FResourceStatModifier> {
+	enum {
+		WithNetSerializer = true
+	};
+};
+
+/*
+ * The amount and last drain time of a UResourceComponentBase, replicated together under its replication policy.
+ * The amount is sent in 1/AmountSteps steps, so whole amounts stay exact, and the drain time in milliseconds.
+ * Each is sent with only as many bits as its value needs.
+ */
+USTRUCT()
+struct FResourceReplicatedState {
+	GENERATED_BODY()
+	static constexpr float AmountSteps = 256.f;
+	// Bits of the bit count that precedes each packed value.
+	static constexpr uint32 BitCountBits = 6;
+
+	UPROPERTY()
+	float Amount = 100.f;
+	// Server world time.
+	UPROPERTY()
+	float TimeAtLastDrain = 0.f;
+
+	/*
+	 * Iris uses FResourceReplicatedStateNetSerializer, which sends the same bits, and its deltas send the drain time
+	 * relative to the previous one.
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	static uint32 QuantizeAmount(float amount);
+	static float DequantizeAmount(uint32 value);
+	static uint32 QuantizeTime(float time);
+	static float DequantizeTime(uint32 value);
+	static uint32 GetPackedBitCount(uint32 value) { return 32U - FMath::CountLeadingZeros(value); }
+};
+template<>
+struct TStructOpsTypeTraits<FResourceReplicatedState> : public TStructOpsTypeTraitsBase2<FResourceReplicatedState> {
+	enum {
+		WithNetSerializer = true
+	};
+};
+
+/*
+ * Replaces one value of the archetype for a single component.
+ */
+USTRUCT(BlueprintType)
+struct FResourceArchetypeOverride {
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Archetype")
+	TEnumAsByte<EResourceStat> Stat = RS_MaxAmount;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Variable|Archetype")
+	float Value = 0.f;
+};
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGenericResourceEvent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnValueResourceEvent, float, value);
+// Native counterpart of both delegates above. The value is meaningless for events that have none.
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnResourceNativeEvent, float /*value*/);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnResourceThresholdEvent, int32, thresholdId, bool, bRising, float, value);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnResourceThresholdNative, int32 /*thresholdId*/, bool /*bRising*/, float /*value*/);
 
 UCLASS(Blueprintable, BlueprintType, ClassGroup=(Resource), meta=(BlueprintSpawnableComponent) )
 class RESOURCECOMPPLUGIN_API UResourceComponentBase : public UActorComponent
@@ -65,6 +218,15 @@ public:
 	 * Also called immediately after RegenStart.
 	 */UPROPERTY(BlueprintAssignable, Category = "Resource")
 	FOnValueResourceEvent OnRegenTick;
+	/*
+	 * Called when the current amount crosses a threshold registered with Add Threshold.
+	 * Always immediate, even when events are batched.
+	 */UPROPERTY(BlueprintAssignable, Category = "Resource|Thresholds")
+	FOnResourceThresholdEvent OnThresholdCrossed;
+	/*
+	 * Native version of OnThresholdCrossed. Only broadcast when bound.
+	 */
+	FOnResourceThresholdNative OnThresholdCrossedNative;
 
 	/*
 	 * Increases the resource by a certain amount.
@@ -133,20 +295,100 @@ public:
 	 * Gets the value of the current amount of resource.
 	 */UFUNCTION(BlueprintCallable, Category = "Resource", meta = (DisplayName = "Get Current Amount"))
 	 virtual float GetCurrentAmount() const {
-		 return CurrentAmount;
+		 return State.Amount;
 	 }
 	 /*
 	 * Returns a percent (0 - 1.0) available of the resource.
 	 * (Returns Current/Maximum)
 	 */UFUNCTION(BlueprintCallable, Category = "Resource", meta = (DisplayName = "Get Current Percent"))
 	 virtual float GetCurrentPercent() const {
-		 return CurrentAmount / K2_GetMaxAmount();
+		 return ResourceCore::GetPercent(State.Amount, GetEffectiveMaxAmount());
+	 }
+	 /*
+	 * Adds a modifier to MaxAmount or a regen value. Returns its id.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource|Stats")
+	 int32 AddStatModifier(EResourceStat stat, EResourceStatOperation operation, float magnitude, FName source = NAME_None);
+	 /*
+	 * Removes a modifier added with Add Stat Modifier. Returns false if it did not exist.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource|Stats")
+	 bool RemoveStatModifier(int32 modifierId);
+	 /*
+	 * Removes every modifier with the given source. Returns how many were removed.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource|Stats")
+	 int32 RemoveStatModifiersFromSource(FName source);
+	 /*
+	 * Returns the stat with all modifiers applied.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|Stats")
+	 float GetStatValue(EResourceStat stat) const;
+	 /*
+	 * Get Max Amount without the Blueprint thunk unless a Blueprint overrides it.
+	 */
+	 float GetEffectiveMaxAmount() const {
+		 return bMaxAmountOverriddenInScript ? K2_GetMaxAmount() : GetMaxAmount();
+	 }
+	 /*
+	 * Registers a threshold on this machine. OnThresholdCrossed only fires when the current amount reaches it
+	 * in the given direction, instead of on every change.
+	 * @param value An amount, or a percent (0 - 1.0) of Get Max Amount if bPercent is set.
+	 * @param hysteresis After firing, the value must move this far back past the threshold before it can fire again in that direction.
+	 * @return The id passed to OnThresholdCrossed and Remove Threshold.
+	 */UFUNCTION(BlueprintCallable, Category = "Resource|Thresholds")
+	 int32 AddThreshold(float value, bool bPercent = false, EResourceThresholdDirection direction = RTD_Both, float hysteresis = 0.f);
+	 /*
+	 * Removes a threshold registered with Add Threshold. Returns false if it did not exist.
+	 */UFUNCTION(BlueprintCallable, Category = "Resource|Thresholds")
+	 bool RemoveThreshold(int32 thresholdId);
+	 /*
+	 * Broadcasts the delegate for a single event type. Used by both the immediate and the batched event paths.
+	 */
+	 void BroadcastEvent(EResourceEventType type, float value);
+	 /*
+	 * Native delegate for an event type. Broadcast alongside the Blueprint delegate, but only when bound,
+	 * so C++ listeners avoid the reflection cost. e.g. OnNativeEvent(RET_Empty).AddLambda([](float) {});
+	 */
+	 FOnResourceNativeEvent& OnNativeEvent(EResourceEventType type) {
+		 check(type < RET_MAX);
+		 return NativeEvents[type];
 	 }
+	 /*
+	 * Calls func for every event type set in the ResourceCore event flags, in a fixed dispatch order that does not
+	 * reflect the order the events happened in.
+	 */
+	 static void ForEachEventType(uint32 events, TFunctionRef<void(EResourceEventType)> func);
+	 /*
+	 * Takes over state simulated elsewhere, e.g. by a Mass entity being promoted to an actor. Server only, after BeginPlay.
+	 * Times are world seconds. Regen is rescheduled from the imported state, replacing any regen already scheduled.
+	 */
+	 void ImportState(const ResourceCore::FResourceState& state);
+	 /*
+	 * At Reduced, regen is applied in batches every ResourceComp.SimLOD.ReducedRegenInterval seconds. At Dormant it is
+	 * not applied until the resource changes or is promoted, so Get Current Amount can lag behind. Either way the
+	 * amounts and regen schedule catch up to exactly what Full would have produced, regen start, tick and end events
+	 * are not sent, and Health resources reuse their modification results per damage type. Regen run by the world
+	 * store is already batched and is not affected. Server only.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource|Performance")
+	 void SetSimulationLOD(EResourceSimulationLOD newLOD);
+	 UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|Performance")
+	 EResourceSimulationLOD GetSimulationLOD() const { return SimulationLOD; }
+	/*
+	 * Changes which clients receive this resource's state. Server only.
+	 */UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Resource|Replication")
+	 void SetReplicationPolicy(EResourceReplicationPolicy newPolicy);
+	 UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|Replication")
+	 EResourceReplicationPolicy GetReplicationPolicy() const { return ReplicationPolicy; }
 protected:
 	/*
 	 * The name of this resource.
 	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
 	FName ResourceName = "Default";
+	/*
+	 * Shared configuration. If set, it replaces the values below on BeginPlay, and Health resources share its rules.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	TObjectPtr<UResourceArchetypeData> Archetype;
+	/*
+	 * Values that differ from the archetype for this component only.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource", meta = (EditCondition = "Archetype != nullptr"))
+	TArray<FResourceArchetypeOverride> ArchetypeOverrides;
 	/*
 	 * The base maximum amount of resource.
 	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
@@ -175,10 +417,57 @@ protected:
 	 * If true the resource will generate even after depletion. Useful for renewable resources such as Stamina.
 	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
 	 bool bRegenAfterDepletion = false;
+	/*
+	 * If true, events are queued and dispatched once per frame by the ResourceEventSubsystem instead of immediately.
+	 * Repeated events of the same type within a frame collapse into one carrying the latest value.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Events")
+	 bool bBatchEvents = false;
+	/*
+	 * If true, the server keeps this resource's state in the ResourceWorldStore and regen runs in the store's
+	 * per-frame pass instead of on a timer. Useful when many resources exist at once.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Performance")
+	 bool bUseWorldStore = false;
+	/*
+	 * If true, the server's UResourceSimulationLOD subsystem sets this resource's simulation LOD.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Performance")
+	 bool bUseSimulationLOD = false;
+	/*
+	 * Everyone: every client receives the exact amount and all events.
+	 * Owner Full, Others Percent: the owning client receives the exact amount, stat modifiers and events. Other clients
+	 * only receive the percent, quantized to a byte and sent less often the farther they are from the owner, and raise
+	 * their change events and thresholds from it. Regen events are owner only.
+	 * Owner Only: other clients receive nothing, and Get Current Amount stays at its initial value on them.
+	 * Policies only tell the owner from other clients. The plugin has no notion of teams, so hiding resources from
+	 * an enemy team means not replicating the owning actor to them, which the game sets up.
+	 */UPROPERTY(Replicated, EditAnywhere, BlueprintReadOnly, Category = "Resource|Replication")
+	 TEnumAsByte<EResourceReplicationPolicy> ReplicationPolicy = RRP_Everyone;
 
 	UResourceComponentBase();
 	void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const;
+	virtual void PostInitProperties() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/*
+	 * Copies the archetype's values and then the overrides into this component.
+	 */
+	virtual void ApplyArchetype();
 	virtual void BeginPlay() override;
+	/*
+	 * Called on the server after Set Simulation LOD changed the LOD.
+	 */
+	virtual void OnSimulationLODChanged(EResourceSimulationLOD oldLOD) {}
+	/*
+	 * Sets the replication conditions of the replicated properties from ReplicationPolicy. Server only, called on
+	 * BeginPlay and when the policy changes.
+	 */
+	virtual void ApplyReplicationPolicy();
+	/*
+	 * True if the owner belongs to a remote client's connection.
+	 */
+	bool HasRemoteOwner() const;
+	/*
+	 * Applies the client requests UResourceRPCIntake merged for this resource during the last frame. Server only.
+	 */
+	virtual void ApplyIntakeRequests(const FResourceIntakeRequests& requests);
 	// For the functions below, see the K2_FunctionName versions for details regarding functionality.
 
 	UFUNCTION()
@@ -196,7 +485,7 @@ protected:
 	UFUNCTION()
 	virtual void SetRegenDelay(float newRegenDelay);
 	UFUNCTION()
-	virtual float GetMaxAmount() const { return MaxAmount; }
+	virtual float GetMaxAmount() const { return GetStat(RS_MaxAmount, MaxAmount); }
 	UFUNCTION()
 	virtual void SetCanBeDrained(bool bCanBeDrained) { bDrainDisabled = !bCanBeDrained; }
 	UFUNCTION()
@@ -204,10 +493,40 @@ protected:
 
 private:
 	UPROPERTY(Replicated)
-	float CurrentAmount = 100.f;
+	FResourceReplicatedState State;
 
-	UPROPERTY(Replicated)
-	float TimeAtLastDrain = 0.f;
+	// Replicated so clients aggregate the same max amount for percents and UI.
+	UPROPERTY(ReplicatedUsing = OnRep_StatModifiers)
+	TArray<FResourceStatModifier> StatModifiers;
+	int32 NextStatModifierId = 0;
+
+	// The percent in 1/255 steps, for clients other than the owner under RRP_OwnerFullOthersPercent.
+	// Only 0 and 255 mean empty and full, so those events still fire on the receiving clients.
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedPercent)
+	uint8 ReplicatedPercent = 255;
+	// Server only.
+	double LastPercentSendTime = -1.0;
+	FTimerHandle PercentSendTimer;
+
+	// Aggregated stats. A stat is recomputed when its base value differs from the one it was cached for.
+	// Modifier changes set the cached base to NaN, which never compares equal.
+	mutable float StatCacheBase[RS_MAX];
+	mutable float StatCacheValue[RS_MAX];
+
+	// Set if a Blueprint overrides Get Max Amount, in which case it has to be called.
+	bool bMaxAmountOverriddenInScript = false;
+
+	// Server only, while bUseWorldStore is set. State mirrors the store so it still replicates.
+	UPROPERTY(Transient)
+	TObjectPtr<UResourceWorldStore> WorldStore;
+	FResourceStoreHandle WorldStoreHandle;
+
+	FOnResourceNativeEvent NativeEvents[RET_MAX];
+
+	// Thresholds are local to each machine, like the listeners that register them.
+	ResourceCore::FThresholdSet AmountThresholds;
+	ResourceCore::FThresholdSet PercentThresholds;
+	int32 NextThresholdId = 0;
 
 	// This is only used on the server. No reason for replication.
 	UPROPERTY()
@@ -219,25 +538,76 @@ private:
 	UPROPERTY()
 	bool bDrainDisabled;
 
+	// Server only.
+	TEnumAsByte<EResourceSimulationLOD> SimulationLOD = RSL_Full;
+	// Below Full LOD, the world time of the next regen tick, or negative if none is scheduled. RegenTimer then
+	// only wakes the resource up at Reduced to apply the ticks due.
+	double PendingRegenTime = -1.0;
+
+	/*
+	 * Below Full LOD, applies every regen tick due by now.
+	 */
+	void AdvanceLODRegen();
+	/*
+	 * Below Full LOD, runs RegenTimer at the coarse interval while regen is pending at Reduced, and clears it otherwise.
+	 */
+	void UpdateLODRegenTimer();
+	/*
+	 * Seconds until the next regen tick, or negative if none is scheduled.
+	 */
+	float GetRegenTimeRemaining() const;
+
 	UFUNCTION()
 	bool ShouldRegen() const;
 
 	UFUNCTION()
-	void StopRegenTimer(){ GetWorld()->GetTimerManager().ClearTimer(RegenTimer); RegenTimer.Invalidate(); }
+	void StopRegenTimer(){ GetWorld()->GetTimerManager().ClearTimer(RegenTimer); RegenTimer.Invalidate(); PendingRegenTime = -1.0; }
+
+	UFUNCTION()
+	float GetRegenDelay() const { return ResourceCore::GetRegenDelay(State.Amount, GetRegenParams()); }
+
+	ResourceCore::FRegenParams GetRegenParams() const;
 
+	float GetStat(EResourceStat stat, float base) const {
+		return StatCacheBase[stat] == base ? StatCacheValue[stat] : AggregateStat(stat, base);
+	}
+	float AggregateStat(EResourceStat stat, float base) const;
+
+	UFUNCTION()
+	void OnRep_StatModifiers();
 	UFUNCTION()
-	float GetRegenDelay() const { return CurrentAmount <= 0 ? bRegenAfterDepletion ? RegenDelay + AdditionalExhaustedDelay : -1 : RegenDelay; }
+	void OnRep_ReplicatedPercent();
+	static uint8 QuantizePercent(float percent);
+	/*
+	 * On clients other than the owner, sets the amount from ReplicatedPercent under RRP_OwnerFullOthersPercent.
+	 */
+	void ApplyReplicatedPercent(bool bBroadcast);
+	/*
+	 * Updates ReplicatedPercent, or schedules the update if the last one is more recent than the send interval.
+	 */
+	void UpdateReplicatedPercent();
+	/*
+	 * ResourceComp.Replication.PercentMaxInterval, scaled by the distance from the owner to the nearest other player.
+	 */
+	float GetPercentSendInterval() const;
+	/*
+	 * Invalidates the cached stats and, on the server, applies the new max amount and regen values.
+	 */
+	void OnStatModifiersChanged();
 
 	UFUNCTION()
 	void SetRegenTimer(float initialDelay = -1);
 
-	UFUNCTION(Server, Reliable)
+	// Client requests go through UResourceRPCIntake, which rate limits them per connection and applies them once per frame.
+	friend class UResourceRPCIntake;
+
+	UFUNCTION(Server, Reliable, WithValidation)
 	void RegisterDrainTime_Server(float time);
 
-	UFUNCTION(Server, Reliable)
+	UFUNCTION(Server, Reliable, WithValidation)
 	void AddResource_Server(float additional);
 
-	UFUNCTION(Server, Reliable)
+	UFUNCTION(Server, Reliable, WithValidation)
 	void DrainResource_Server(float removal);
 
 	UFUNCTION(NetMulticast, Reliable)
@@ -246,4 +616,41 @@ private:
 	UFUNCTION(NetMulticast, Reliable)
 	void BroadcastRegenEvent_Net(EHealthRegenEventType type, float newValue = 0);
 
+	UFUNCTION(Client, Reliable)
+	void BroadcastResourceChange_Owner(float oldValue, float newValue);
+
+	UFUNCTION(Client, Reliable)
+	void BroadcastRegenEvent_Owner(EHealthRegenEventType type, float newValue = 0);
+
+	/*
+	 * Server side. Sends a change or regen event to the clients the replication policy allows.
+	 */
+	void SendResourceChange(float oldValue, float newValue);
+	void SendRegenEvent(EHealthRegenEventType type, float newValue = 0);
+	/*
+	 * Raises the events for a change or regen event on this machine.
+	 */
+	void ReceiveResourceChange(float oldValue, float newValue);
+	void ReceiveRegenEvent(EHealthRegenEventType type, float newValue);
+
+	/*
+	 * Broadcasts the events now, or queues them on the event subsystem if bBatchEvents is set.
+	 */
+	void DispatchEvents(uint32 events, float value);
+	/*
+	 * Broadcasts OnThresholdCrossed for every threshold between the old and new value.
+	 */
+	void EvaluateThresholds(float oldValue, float newValue);
+
+	friend class UResourceWorldStore;
+	bool IsUsingWorldStore() const { return WorldStore != nullptr; }
+	/*
+	 * Pushes the current amount, max amount and regen values to the world store.
+	 */
+	void SyncWorldStore();
+	/*
+	 * Copies the stored amount back and broadcasts the ResourceCore events the store produced.
+	 */
+	void ApplyWorldStoreEvents(float oldValue, uint32 events);
+
 };
@@ -0,0 +1,255 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+// This header is plain C++ on purpose. Nothing in here may depend on the engine, so the resource math can be
+// compiled, tested and benchmarked on its own. The components convert their UPROPERTYs into these types.
+#include <cstdint>
+#include <vector>
+
+#ifndef RESOURCECOMPPLUGIN_API
+#define RESOURCECOMPPLUGIN_API
+#endif
+
+namespace ResourceCore {
+
+	/*
+	 * Mirrors EIncomingDamageChannel.
+	 */
+	enum class EDamageChannel : uint8_t {
+		All,
+		Point,
+		Radial,
+		Generic
+	};
+	/*
+	 * Mirrors EIncomingDamageModificationType.
+	 */
+	enum class EModificationType : uint8_t {
+		Add,
+		Multiply,
+		Override,
+		FromDamageType
+	};
+	/*
+	 * Events produced by a state change. Mirrors the delegates on UResourceComponentBase.
+	 */
+	enum EEventFlags : uint32_t {
+		Event_None = 0,
+		Event_Changed = 1 << 0,
+		Event_Drained = 1 << 1,
+		Event_Added = 1 << 2,
+		Event_Emptied = 1 << 3,
+		Event_Filled = 1 << 4,
+		Event_RegenStart = 1 << 5,
+		Event_RegenTick = 1 << 6,
+		Event_RegenEnd = 1 << 7,
+		Event_All = (1 << 8) - 1
+	};
+
+	/*
+	 * An opaque damage type identity. The engine side passes the UClass pointer.
+	 */
+	using FTypeId = uintptr_t;
+	/*
+	 * An opaque name identity. The engine side packs the FName comparison index and number.
+	 */
+	using FNameId = uint64_t;
+
+	struct FAmountChange {
+		float OldValue = 0.f;
+		float NewValue = 0.f;
+	};
+
+	struct FRegenParams {
+		float Amount = 5.f;
+		float Rate = 5.f;
+		float Delay = 1.f;
+		float AdditionalExhaustedDelay = 0.f;
+		bool bRegenAfterDepletion = false;
+	};
+
+	/*
+	 * The mutable part of a resource.
+	 * NextRegenTime is negative while regen is not scheduled.
+	 */
+	struct FResourceState {
+		float Current = 100.f;
+		float Max = 100.f;
+		double TimeAtLastDrain = 0.0;
+		double NextRegenTime = -1.0;
+		bool bDrainDisabled = false;
+		bool bFirstRegenTick = false;
+	};
+
+	struct FModificationRule {
+		EDamageChannel Channel = EDamageChannel::All;
+		EModificationType Type = EModificationType::Multiply;
+		float Magnitude = 1.f;
+		float MinimumRange = 0.f;
+		float MaximumRange = 0.f;
+		std::vector<FNameId> Bones;
+		std::vector<FTypeId> DamageTypes;
+		bool bIncludeChildTypes = false;
+	};
+
+	/*
+	 * Mirrors EResourceStatOperation. Layers apply in this order.
+	 */
+	enum class EStatOperation : uint8_t {
+		Flat,
+		PercentAdd,
+		Multiply,
+		Override
+	};
+	struct FStatModifier {
+		EStatOperation Operation = EStatOperation::Flat;
+		float Magnitude = 0.f;
+	};
+
+	enum class EThresholdDirection : uint8_t {
+		Falling = 1 << 0,
+		Rising = 1 << 1,
+		Both = Falling | Rising
+	};
+	/*
+	 * A value the resource can cross. After firing in a direction, that direction is disarmed until the value
+	 * moves Hysteresis past the threshold the other way, so a resource hovering around it does not spam listeners.
+	 */
+	struct FThreshold {
+		float Value = 0.f;
+		float Hysteresis = 0.f;
+		EThresholdDirection Direction = EThresholdDirection::Both;
+		int32_t Id = 0;
+		bool bFallingArmed = false;
+		bool bRisingArmed = false;
+	};
+	/*
+	 * Thresholds sorted by value, so a change only visits the thresholds between its old and new value.
+	 */
+	struct FThresholdSet {
+		std::vector<FThreshold> Thresholds;
+		float MaxHysteresis = 0.f;
+	};
+	struct FThresholdCrossing {
+		int32_t Id = 0;
+		bool bRising = false;
+	};
+
+	struct FDamageQuery {
+		float Damage = 0.f;
+		EDamageChannel Channel = EDamageChannel::Generic;
+		FTypeId DamageType = 0;
+		FNameId Bone = 0;
+		// Distance between the damage origin and the damaged resource's owner.
+		float Distance = 0.f;
+	};
+
+	/*
+	 * A matching rule's effect, once its conditions have been evaluated. See FilterRules.
+	 */
+	struct FDamageStep {
+		EModificationType Type = EModificationType::Multiply;
+		float Magnitude = 1.f;
+	};
+
+	/*
+	 * Hooks for the parts of rule evaluation that need type information.
+	 * Unset hooks behave as "not a child" and "not implemented".
+	 */
+	struct FDamageTypeOps {
+		bool (*IsChildOf)(FTypeId child, FTypeId parent) = nullptr;
+		// Returns true and writes outDamage if the damage type modifies damage itself.
+		bool (*ModifyFromDamageType)(const void* context, FTypeId damageType, float damage, float& outDamage) = nullptr;
+		const void* Context = nullptr;
+	};
+
+	// Amounts
+
+	/*
+	 * Adds to the current amount, clamped to the maximum.
+	 */
+	RESOURCECOMPPLUGIN_API FAmountChange ApplyAdd(float current, float addAmount, float maxAmount);
+	/*
+	 * Removes from the current amount, clamped to 0.
+	 */
+	RESOURCECOMPPLUGIN_API FAmountChange ApplyDrain(float current, float drainAmount);
+	/*
+	 * Returns Current/Maximum, or 0 when the maximum is not positive.
+	 */
+	RESOURCECOMPPLUGIN_API float GetPercent(float current, float maxAmount);
+	/*
+	 * Returns the event flags the change should broadcast.
+	 */
+	RESOURCECOMPPLUGIN_API uint32_t GetChangeEvents(const FAmountChange& change, float maxAmount);
+
+	// Regen
+
+	/*
+	 * Delay before regen begins at the given amount. Negative if the resource should not regen.
+	 */
+	RESOURCECOMPPLUGIN_API float GetRegenDelay(float current, const FRegenParams& params);
+	RESOURCECOMPPLUGIN_API bool ShouldRegen(float current, const FRegenParams& params);
+	inline double GetRegenInterval(const FRegenParams& params) { return params.Rate > 0 ? 1.0 / params.Rate : -1.0; }
+
+	// State machine. These follow UResourceComponentBase's Add/Drain/regen timer exactly, without a timer manager.
+
+	/*
+	 * Adds to the state. Negative amounts drain.
+	 */
+	RESOURCECOMPPLUGIN_API uint32_t Add(FResourceState& state, float amount, double now, const FRegenParams& params);
+	/*
+	 * Drains the state, records the drain time and reschedules regen. Negative amounts add.
+	 */
+	RESOURCECOMPPLUGIN_API uint32_t Drain(FResourceState& state, float amount, double now, const FRegenParams& params);
+	/*
+	 * Reschedules regen as if a drain just happened.
+	 */
+	RESOURCECOMPPLUGIN_API uint32_t RestartRegen(FResourceState& state, double now, const FRegenParams& params);
+	/*
+	 * Applies every regen tick due at or before now in constant time.
+	 * @param outTicks Optional. Receives how many ticks were applied.
+	 */
+	RESOURCECOMPPLUGIN_API uint32_t AdvanceRegen(FResourceState& state, double now, const FRegenParams& params, int64_t* outTicks = nullptr);
+
+	// Stats
+
+	/*
+	 * (base + sum of Flat) * (1 + sum of PercentAdd) * product of Multiply.
+	 * If any Override is present, the last one replaces the result.
+	 */
+	RESOURCECOMPPLUGIN_API float AggregateStat(float base, const FStatModifier* modifiers, int32_t numModifiers);
+
+	// Thresholds
+
+	/*
+	 * Inserts the threshold, armed according to where currentValue sits relative to it.
+	 */
+	RESOURCECOMPPLUGIN_API void AddThreshold(FThresholdSet& set, FThreshold threshold, float currentValue);
+	RESOURCECOMPPLUGIN_API bool RemoveThreshold(FThresholdSet& set, int32_t id);
+	/*
+	 * Appends every threshold crossed by moving from oldValue to newValue, nearest to oldValue first,
+	 * and updates the armed state of the thresholds. A threshold is crossed when the value reaches it.
+	 */
+	RESOURCECOMPPLUGIN_API void EvaluateThresholds(FThresholdSet& set, float oldValue, float newValue, std::vector<FThresholdCrossing>& outCrossings);
+
+	// Damage modification. Equivalent to UHealthResource::ModifyDamage and ModificationAcceptsDamageType.
+
+	RESOURCECOMPPLUGIN_API bool AcceptsDamageType(const FModificationRule& rule, FTypeId damageType, const FDamageTypeOps& ops);
+	RESOURCECOMPPLUGIN_API bool RuleMatches(const FModificationRule& rule, const FDamageQuery& query, const FDamageTypeOps& ops);
+	RESOURCECOMPPLUGIN_API float ModifyDamage(const FModificationRule* rules, int32_t numRules, const FDamageQuery& query, const FDamageTypeOps& ops);
+	inline float ModifyDamage(const std::vector<FModificationRule>& rules, const FDamageQuery& query, const FDamageTypeOps& ops) {
+		return ModifyDamage(rules.data(), static_cast<int32_t>(rules.size()), query, ops);
+	}
+	/*
+	 * The steps of every rule that matches the channel and damage type, in order, so repeated hits of that kind can skip
+	 * rule matching. Returns false if a rule that could match depends on the bone or distance, which differ per hit.
+	 */
+	RESOURCECOMPPLUGIN_API bool FilterRules(const FModificationRule* rules, int32_t numRules, EDamageChannel channel, FTypeId damageType,
+		const FDamageTypeOps& ops, std::vector<FDamageStep>& outSteps);
+	/*
+	 * Same result as ModifyDamage, for a query of the channel and damage type the steps were filtered for.
+	 */
+	RESOURCECOMPPLUGIN_API float ApplyDamageSteps(const std::vector<FDamageStep>& steps, const FDamageQuery& query, const FDamageTypeOps& ops);
+}
+
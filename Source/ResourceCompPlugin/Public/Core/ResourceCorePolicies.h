@@ -0,0 +1,209 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+// Plain C++, like ResourceCore.h. The resource state machine as a template over behavior policies, so a resource type
+// whose behavior is fixed in native code compiles to straight-line code: checks its policies rule out and events it
+// never listens to are removed at compile time. The ResourceCore free functions are the fully runtime-configured
+// instantiation, FDefaultResourceCore, which is what the Blueprint-configurable components use.
+#include "Core/ResourceCore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ResourceCore {
+
+	namespace Policy {
+
+		// Clamping
+
+		/*
+		 * Amounts stay within [0, Max]. Adding to a full resource does nothing.
+		 */
+		struct FClampToRange {
+			static constexpr bool bAllowOverfill = false;
+		};
+		/*
+		 * Adds may go past Max, e.g. for overheal or shields. Regen still stops at Max, and Filled fires when Max is reached.
+		 */
+		struct FAllowOverfill {
+			static constexpr bool bAllowOverfill = true;
+		};
+
+		// Regen after depletion
+
+		/*
+		 * Follows FRegenParams::bRegenAfterDepletion.
+		 */
+		struct FDepletionFromParams {
+			static bool RegenAfterDepletion(const FRegenParams& params) { return params.bRegenAfterDepletion; }
+		};
+		struct FAlwaysRegenAfterDepletion {
+			static constexpr bool RegenAfterDepletion(const FRegenParams&) { return true; }
+		};
+		struct FNeverRegenAfterDepletion {
+			static constexpr bool RegenAfterDepletion(const FRegenParams&) { return false; }
+		};
+
+		// Drain lockout
+
+		/*
+		 * Follows FResourceState::bDrainDisabled.
+		 */
+		struct FLockoutFromState {
+			static bool IsDrainLocked(const FResourceState& state) { return state.bDrainDisabled; }
+		};
+		struct FNoDrainLockout {
+			static constexpr bool IsDrainLocked(const FResourceState&) { return false; }
+		};
+	}
+
+	/*
+	 * Add, Drain and regen with the same semantics as the ResourceCore free functions.
+	 * @param TClamp One of the clamping policies.
+	 * @param TDepletion One of the regen after depletion policies.
+	 * @param TLockout One of the drain lockout policies.
+	 * @param TEvents The EEventFlags this type reports. Others are never computed and never returned.
+	 */
+	template<typename TClamp, typename TDepletion, typename TLockout, uint32_t TEvents = Event_All>
+	struct TResourceCore {
+		static constexpr uint32_t Events = TEvents;
+
+		static uint32_t GetChangeEvents(const FAmountChange& change, float maxAmount) {
+			if constexpr (Events == Event_None) {
+				return Event_None;
+			}
+			else {
+				if (change.OldValue == change.NewValue) {
+					return Event_None;
+				}
+				uint32_t flags = Event_Changed;
+				if constexpr ((Events & (Event_Drained | Event_Added)) != 0) {
+					flags |= change.OldValue > change.NewValue ? Event_Drained : Event_Added;
+				}
+				if constexpr ((Events & Event_Emptied) != 0) {
+					if (change.NewValue == 0) {
+						flags |= Event_Emptied;
+					}
+				}
+				if constexpr ((Events & Event_Filled) != 0) {
+					if (TClamp::bAllowOverfill ? change.OldValue < maxAmount && change.NewValue >= maxAmount : change.NewValue == maxAmount) {
+						flags |= Event_Filled;
+					}
+				}
+				return flags & Events;
+			}
+		}
+
+		static float GetRegenDelay(float current, const FRegenParams& params) {
+			if (current <= 0) {
+				return TDepletion::RegenAfterDepletion(params) ? params.Delay + params.AdditionalExhaustedDelay : -1.f;
+			}
+			return params.Delay;
+		}
+		static bool ShouldRegen(float current, const FRegenParams& params) {
+			return params.Amount > 0 && params.Rate > 0 && GetRegenDelay(current, params) >= 0;
+		}
+
+		static uint32_t Add(FResourceState& state, float amount, double now, const FRegenParams& params) {
+			if (amount < 0) {
+				return Drain(state, -amount, now, params);
+			}
+			FAmountChange change{ state.Current, state.Current + amount };
+			if constexpr (!TClamp::bAllowOverfill) {
+				if (state.Current >= state.Max) {
+					return Event_None;
+				}
+				change.NewValue = std::min(state.Max, change.NewValue);
+			}
+			state.Current = change.NewValue;
+			return GetChangeEvents(change, state.Max);
+		}
+		static uint32_t Drain(FResourceState& state, float amount, double now, const FRegenParams& params) {
+			if (amount < 0) {
+				return Add(state, -amount, now, params);
+			}
+			if (TLockout::IsDrainLocked(state)) {
+				return Event_None;
+			}
+			const FAmountChange change{ state.Current, std::max(0.f, state.Current - amount) };
+			state.Current = change.NewValue;
+			state.TimeAtLastDrain = now;
+
+			uint32_t flags = GetChangeEvents(change, state.Max);
+			if constexpr ((Events & Event_RegenEnd) != 0) {
+				// Regen only ends if it had begun ticking.
+				if (state.NextRegenTime >= 0 && !state.bFirstRegenTick) {
+					flags |= Event_RegenEnd;
+				}
+			}
+			return flags | RestartRegen(state, now, params);
+		}
+		static uint32_t RestartRegen(FResourceState& state, double now, const FRegenParams& params) {
+			if (!ShouldRegen(state.Current, params)) {
+				state.NextRegenTime = -1.0;
+				state.bFirstRegenTick = false;
+				return Event_None;
+			}
+			state.NextRegenTime = now + GetRegenDelay(state.Current, params);
+			state.bFirstRegenTick = true;
+			return Event_None;
+		}
+		static uint32_t AdvanceRegen(FResourceState& state, double now, const FRegenParams& params, int64_t* outTicks = nullptr) {
+			if (outTicks) {
+				*outTicks = 0;
+			}
+			if (state.NextRegenTime < 0 || now < state.NextRegenTime) {
+				return Event_None;
+			}
+			const double interval = GetRegenInterval(params);
+			if (interval <= 0 || params.Amount <= 0 || state.Current >= state.Max) {
+				const uint32_t flags = state.bFirstRegenTick ? Event_None : Event_RegenEnd;
+				state.NextRegenTime = -1.0;
+				state.bFirstRegenTick = false;
+				return flags & Events;
+			}
+			const int64_t dueTicks = static_cast<int64_t>(std::floor((now - state.NextRegenTime) / interval)) + 1;
+			const int64_t ticksToFill = std::max<int64_t>(1, static_cast<int64_t>(std::ceil((state.Max - state.Current) / params.Amount)));
+			const int64_t ticks = std::min(dueTicks, ticksToFill);
+
+			// Regen never overfills, whatever the clamping policy.
+			const FAmountChange change{ state.Current, std::min(state.Max, state.Current + static_cast<float>(ticks) * params.Amount) };
+			state.Current = change.NewValue;
+
+			uint32_t flags = Event_RegenTick | GetChangeEvents(change, state.Max);
+			if (state.bFirstRegenTick) {
+				state.bFirstRegenTick = false;
+				flags |= Event_RegenStart;
+			}
+			if (state.Current >= state.Max) {
+				state.NextRegenTime = -1.0;
+				flags |= Event_RegenEnd;
+			}
+			else {
+				state.NextRegenTime += static_cast<double>(ticks) * interval;
+			}
+			if (outTicks) {
+				*outTicks = ticks;
+			}
+			return flags & Events;
+		}
+	};
+
+	/*
+	 * Everything configured at runtime. The ResourceCore free functions forward to this.
+	 */
+	using FDefaultResourceCore = TResourceCore<Policy::FClampToRange, Policy::FDepletionFromParams, Policy::FLockoutFromState>;
+	/*
+	 * ULiteResourceComponent only reports that the amount changed.
+	 */
+	using FLiteResourceCore = TResourceCore<Policy::FClampToRange, Policy::FDepletionFromParams, Policy::FLockoutFromState, Event_Changed>;
+	/*
+	 * Fixed-behavior presets for native resource types that are not configured from Blueprint.
+	 * Health stays down once depleted, stamina and mana always recover, and only health can be made invulnerable.
+	 */
+	using FHealthResourceCore = TResourceCore<Policy::FClampToRange, Policy::FNeverRegenAfterDepletion, Policy::FLockoutFromState>;
+	using FStaminaResourceCore = TResourceCore<Policy::FClampToRange, Policy::FAlwaysRegenAfterDepletion, Policy::FNoDrainLockout,
+		Event_Changed | Event_Emptied | Event_Filled>;
+	using FManaResourceCore = TResourceCore<Policy::FClampToRange, Policy::FAlwaysRegenAfterDepletion, Policy::FNoDrainLockout, Event_Changed>;
+}
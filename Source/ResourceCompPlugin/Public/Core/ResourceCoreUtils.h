@@ -0,0 +1,27 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Core/ResourceCore.h"
+#include "Data/DamageModificationData.h"
+
+class AActor;
+class UDamageType;
+
+/**
+ * Conversions between the engine types and the engine-independent ResourceCore types.
+ */
+namespace ResourceCore {
+	RESOURCECOMPPLUGIN_API EDamageChannel ToCoreChannel(EIncomingDamageChannel channel);
+	RESOURCECOMPPLUGIN_API FNameId MakeNameId(FName name);
+	RESOURCECOMPPLUGIN_API FTypeId MakeTypeId(const UDamageType* damageType);
+	RESOURCECOMPPLUGIN_API FTypeId MakeTypeId(const UClass* damageClass);
+	RESOURCECOMPPLUGIN_API FModificationRule MakeRule(const FIncomingDamageModification& modification);
+	RESOURCECOMPPLUGIN_API void MakeRules(TConstArrayView<FIncomingDamageModification> modifications, std::vector<FModificationRule>& outRules);
+	/*
+	 * Type hooks backed by UClass and IDamageTypeModificationInterface.
+	 * @param damagedActor Passed to the interface. Must outlive the returned ops.
+	 */
+	RESOURCECOMPPLUGIN_API FDamageTypeOps MakeDamageTypeOps(const AActor* damagedActor);
+}
@@ -0,0 +1,90 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Core/ResourceCore.h"
+#include "Data/DamageModificationData.h"
+#include "ResourceArchetypeData.generated.h"
+
+/*
+ * Rules shared by the health resources of one archetype, and their compiled form.
+ */
+struct FResourceSharedRules {
+	TArray<FIncomingDamageModification> Rules;
+	std::vector<ResourceCore::FModificationRule> CompiledRules;
+	bool bBuilt = false;
+};
+
+/**
+ * Configuration shared by every resource that references it.
+ * Components copy the scalar values on BeginPlay and apply their own sparse overrides on top. Health resources
+ * share the rule array and its compiled form instead of each holding a copy, until one of them changes its rules.
+ * Health resources that add the same default modification data on top share one more set with it merged in.
+ */
+UCLASS(BlueprintType)
+class RESOURCECOMPPLUGIN_API UResourceArchetypeData : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = "Resource")
+	FText Description = FText::FromString("This variable is never used and is for the editor only. It is for a quick note of the Data Asset when viewing it in the editor.");
+	/*
+	 * The base maximum amount of resource.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	float MaxAmount = 100.f;
+	/*
+	 * If true, the resource begins at 0 instead of Get Max Amount.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource")
+	bool bRegenBeginsEmpty = false;
+	/*
+	 * How much resource is filled per tick.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenAmount = 5.f;
+	/*
+	 * How many ticks per second occur.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenRate = 5.f;
+	/*
+	 * The delay after draining the resource when regen begins.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float RegenDelay = 1.f;
+	/*
+	 * This is added to RegenDelay if regen begins when CurrentAmount is 0.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	float AdditionalExhaustedDelay = 0.f;
+	/*
+	 * If true the resource will generate even after depletion.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|Regen")
+	bool bRegenAfterDepletion = false;
+	/**
+	 * Modifications every health resource using this archetype starts with, in array order.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Health|Modifications", meta = (TitleProperty = "ModificationName"))
+	TArray<FIncomingDamageModification> ModificationRules;
+	/**
+	 * Added after ModificationRules.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Health|Modifications")
+	TObjectPtr<UDamageModificationData> DefaultModificationData;
+
+	/*
+	 * ModificationRules followed by DefaultModificationData, then by extraData if given. Built once per extraData,
+	 * game thread only. The returned set lives as long as the archetype, and its compiled rules are safe to read
+	 * from any thread.
+	 */
+	const FResourceSharedRules& GetSharedRules(const UDamageModificationData* extraData = nullptr) const;
+	/*
+	 * The compiled rules of GetSharedRules without extra data. Call GetSharedRules first.
+	 */
+	const std::vector<ResourceCore::FModificationRule>& GetCompiledRules() const { return SharedRules.CompiledRules; }
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	mutable FResourceSharedRules SharedRules;
+	// Allocated separately so resources can keep pointers to them while the map grows.
+	mutable TMap<TObjectKey<UDamageModificationData>, TUniquePtr<FResourceSharedRules>> ExtendedRules;
+};
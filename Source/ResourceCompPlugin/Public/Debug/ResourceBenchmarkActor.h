@@ -0,0 +1,31 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ResourceBenchmarkActor.generated.h"
+
+class UHealthResource;
+class ULiteResourceComponent;
+
+/**
+ * Replicated target spawned by the network benchmark. Carries a UHealthResource and a ULiteResourceComponent and
+ * nothing else, so every byte measured for it belongs to the resource components.
+ */
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class RESOURCECOMPPLUGIN_API AResourceBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+public:
+	AResourceBenchmarkActor();
+
+	UHealthResource* GetHealthResource() const { return HealthResource; }
+	ULiteResourceComponent* GetLiteResource() const { return LiteResource; }
+
+private:
+	UPROPERTY()
+	TObjectPtr<UHealthResource> HealthResource;
+	UPROPERTY()
+	TObjectPtr<ULiteResourceComponent> LiteResource;
+};
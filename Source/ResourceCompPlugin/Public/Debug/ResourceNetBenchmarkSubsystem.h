@@ -0,0 +1,110 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ResourceNetBenchmarkSubsystem.generated.h"
+
+class AResourceBenchmarkActor;
+class UActorComponent;
+
+USTRUCT()
+struct FResourceNetBenchmarkSettings {
+	GENERATED_BODY()
+	/*
+	 * How many replicated targets are spawned on the server.
+	 */UPROPERTY()
+	int32 NumActors = 64;
+	/*
+	 * How long the workload runs in seconds. The report is printed when it ends.
+	 */UPROPERTY()
+	float Duration = 30.f;
+	/*
+	 * Hits applied to each target per second. Hits alternate between Point and Generic damage.
+	 */UPROPERTY()
+	float HitsPerSecond = 2.f;
+	/*
+	 * Damage per hit, also drained from each target's lite resource. Regen refills the targets between hits using
+	 * the components' own regen settings.
+	 */UPROPERTY()
+	float Damage = 10.f;
+	/*
+	 * Every interval a modifier is given to or removed from each target. 0 disables modifier churn.
+	 */UPROPERTY()
+	float ModifierInterval = 5.f;
+};
+
+/**
+ * Measures the replication cost of resource components.
+ *
+ * Run PIE as a Listen Server (or Client with a dedicated server) with "Run Under One Process" enabled,
+ * so every client is an in-process connection over the local loopback, then use:
+ *   ResourceComp.NetBench.Start [NumActors] [Duration] [HitsPerSecond] [Damage] [ModifierInterval]
+ *   ResourceComp.NetBench.Stop
+ * The server spawns AResourceBenchmarkActor targets and applies a scripted damage workload while each client
+ * counts the RPCs it receives and the replicated property changes it sees. Properties are compared once per frame,
+ * so several updates within a frame count as one change. The only byte figures are the ones the net connections
+ * measure: sent by each of the server's client connections and received by each client's server connection.
+ * Use "netprofile" for the size of each property and RPC.
+ * Every report names the replication system in use. To compare the legacy path with Iris, run the same workload
+ * once with -UseIrisReplication=0 and once with -UseIrisReplication=1 and compare the bytes per connection.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceNetBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	/*
+	 * Spawns the targets and starts the workload. Server only.
+	 */
+	void StartWorkload(const FResourceNetBenchmarkSettings& settings);
+	/*
+	 * Starts counting received replication. Client only.
+	 */
+	void StartSampling();
+	/*
+	 * Ends the run and prints the report for this world.
+	 */
+	void StopBenchmark();
+	bool IsRunning() const { return bRunning; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FPropertySnapshot {
+		const FProperty* Property = nullptr;
+		uint8* Value = nullptr;
+	};
+	struct FComponentSnapshot {
+		TWeakObjectPtr<UActorComponent> Component;
+		TArray<FPropertySnapshot> Properties;
+	};
+
+	bool bRunning = false;
+	bool bServer = false;
+	float Elapsed = 0.f;
+	float NextHitTime = 0.f;
+	float NextModifierTime = 0.f;
+	int32 HitCount = 0;
+	bool bModifierGiven = false;
+	FResourceNetBenchmarkSettings Settings;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AResourceBenchmarkActor>> Targets;
+
+	// Bytes sent by each of the server's client connections, or received by a client's server connection, integrated
+	// over the run.
+	TMap<FString, double> ConnectionBytes;
+	// Client side. Last seen value of every replicated property on the benchmark components.
+	TArray<FComponentSnapshot> Snapshots;
+
+	void TickWorkload(float deltaTime);
+	void TickSampling();
+	void SampleComponent(UActorComponent* component);
+	void SampleConnections(float deltaTime);
+	void ClearSnapshots();
+	void Report() const;
+};
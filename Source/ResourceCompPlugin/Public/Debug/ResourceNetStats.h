@@ -0,0 +1,53 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define RESOURCE_WITH_NET_STATS !UE_BUILD_SHIPPING
+
+/**
+ * Counters recorded on the receiving side of resource replication.
+ * Only collects while the network benchmark is running (see UResourceNetBenchmarkSubsystem).
+ * Every client world is its own bucket, so in-process PIE clients are reported as separate connections.
+ * Only counts are kept. Sizes are not known at this level, so the benchmark takes bytes from the net connections.
+ */
+struct RESOURCECOMPPLUGIN_API FResourceNetStats {
+	struct FEntry {
+		int64 Count = 0;
+	};
+	struct FConnectionStats {
+		TMap<FName, FEntry> RPCs;
+		TMap<FName, FEntry> Properties;
+	};
+
+	static FResourceNetStats& Get();
+
+	void SetEnabled(bool bNewEnabled) { bEnabled = bNewEnabled; }
+	bool IsEnabled() const { return bEnabled; }
+	void Reset() { Connections.Reset(); }
+
+	/*
+	 * Records an RPC received by a client. Calls on the server are ignored.
+	 */
+	void RecordRPC(const UObject* context, FName rpcName);
+	/*
+	 * Records a replicated property change seen by a client.
+	 */
+	void RecordProperty(const UObject* context, FName propertyName);
+
+	const TMap<FString, FConnectionStats>& GetConnections() const { return Connections; }
+
+private:
+	bool bEnabled = false;
+	TMap<FString, FConnectionStats> Connections;
+
+	FConnectionStats* FindConnection(const UObject* context);
+};
+
+#if RESOURCE_WITH_NET_STATS
+#define RESOURCE_NET_STAT_RPC(Context, RpcName) \
+	if (FResourceNetStats::Get().IsEnabled()) { FResourceNetStats::Get().RecordRPC(Context, FName(TEXT(RpcName))); }
+#else
+#define RESOURCE_NET_STAT_RPC(Context, RpcName)
+#endif
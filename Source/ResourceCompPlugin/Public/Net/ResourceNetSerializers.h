@@ -0,0 +1,42 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "ResourceNetSerializers.generated.h"
+
+// Iris serializers for the resource structs that have a custom NetSerialize, so both replication systems send the
+// same bits. Arrays of these structs, like the stat modifier list, use them for their elements, and Iris only sends
+// the elements that changed.
+
+USTRUCT()
+struct FLiteResourceStateNetSerializerConfig : public FNetSerializerConfig {
+	GENERATED_BODY()
+};
+USTRUCT()
+struct FResourceReplicatedStateNetSerializerConfig : public FNetSerializerConfig {
+	GENERATED_BODY()
+};
+USTRUCT()
+struct FResourceStatModifierNetSerializerConfig : public FNetSerializerConfig {
+	GENERATED_BODY()
+};
+
+namespace UE::Net {
+	/*
+	 * FLiteResourceState. The amount is not quantized because clients run the regen math on it, but the 64-bit regen
+	 * time is only sent while regen is scheduled, and deltas skip the fields that did not change.
+	 */
+	UE_NET_DECLARE_SERIALIZER(FLiteResourceStateNetSerializer, RESOURCECOMPPLUGIN_API);
+	/*
+	 * FResourceReplicatedState. The amount is quantized to 1/256 and the drain time to milliseconds, each sent with
+	 * only the bits it needs. Deltas skip an unchanged amount and send the drain time relative to the previous one.
+	 */
+	UE_NET_DECLARE_SERIALIZER(FResourceReplicatedStateNetSerializer, RESOURCECOMPPLUGIN_API);
+	/*
+	 * FResourceStatModifier. Only the stat and operation in 2 bits each and the magnitude, as clients do not use the
+	 * id or source. Deltas skip an unchanged magnitude.
+	 */
+	UE_NET_DECLARE_SERIALIZER(FResourceStatModifierNetSerializer, RESOURCECOMPPLUGIN_API);
+}
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+RESOURCECOMPPLUGIN_API DECLARE_LOG_CATEGORY_EXTERN(LogResourceComp, Log, All);
+
 class FResourceCompPluginModule : public IModuleInterface
 {
 public:
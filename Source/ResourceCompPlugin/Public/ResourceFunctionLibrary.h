@@ -7,6 +7,7 @@
 #include "ResourceFunctionLibrary.generated.h"
 
 class UResourceComponentBase;
+class ULiteResourceComponent;
 class UHealthResource;
 class UDamageModificationData;
 enum EResourcePercentType;
@@ -35,6 +36,11 @@ public:
 	* Returns all resources with the given name on each actor.
 	*/UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource Function Library")
 	static TArray<UResourceComponentBase*> GetAllResourcesFromActors(TArray<AActor*> actors);
+	/*
+	* Returns the first lite resource with the given name on the actor.
+	* The add and drain functions below fall back to it when the actor has no full resource with that name.
+	*/UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource Function Library")
+	static ULiteResourceComponent* GetLiteResourceFromActor(AActor* actor, FName resourceName = "Default");
 
 	/*
 	* Adds to the first resource with the given name on the actor.
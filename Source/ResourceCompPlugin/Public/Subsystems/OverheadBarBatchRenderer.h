@@ -0,0 +1,84 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/Health/HealthResourceWithUI.h"
+#include "OverheadBarBatchRenderer.generated.h"
+
+class AHUD;
+class UCanvas;
+class UResourceComponentBase;
+
+/*
+ * Where a batched bar's data comes from. Raw pointers, validated by the renderer before every build.
+ */
+struct FOverheadBarSource {
+	const UResourceComponentBase* Resource = nullptr;
+	const AActor* Owner = nullptr;
+	FVector Offset = FVector::ZeroVector;
+	uint8 StyleId = 0;
+	// OverheadWidgetSettings hides the bar from the local viewer.
+	bool bHidden = false;
+};
+
+/*
+ * One bar to draw this frame.
+ */
+struct FOverheadBarInstance {
+	FVector WorldPosition = FVector::ZeroVector;
+	float Percent = 0.f;
+	uint8 StyleId = 0;
+};
+
+/**
+ * Draws the overhead bars of every health resource with OverheadRenderMode set to Batched, without widgets, and a
+ * placeholder for per-actor widgets that are still loading or queued.
+ * Each frame the bars in range and in front of the local view are gathered into a compact instance array, reading
+ * the percents straight from the components. The array is then drawn on the HUD canvas in one pass of white tiles,
+ * which the canvas batches into a single draw. Building does not touch the renderer, so it also runs under -nullrhi,
+ * where nothing is drawn. Never created on dedicated servers.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UOverheadBarBatchRenderer : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UOverheadBarBatchRenderer* Get(const UObject* worldContext);
+
+	void Register(UHealthResourceWithUI* resource);
+	void Unregister(UHealthResourceWithUI* resource);
+	/*
+	 * The bars built this frame.
+	 */
+	TConstArrayView<FOverheadBarInstance> GetInstances() const { return Instances; }
+	TConstArrayView<FOverheadBarStyle> GetStyles() const { return Styles; }
+
+	/*
+	 * Appends an instance for every source within range and in front of the view.
+	 * @param bRequireRendered If true, sources whose owner was not rendered recently are skipped.
+	 */
+	static void BuildInstances(TConstArrayView<FOverheadBarSource> sources, const FVector& viewLocation, const FVector& viewDirection,
+		float maxDistance, bool bRequireRendered, TArray<FOverheadBarInstance>& outInstances);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Sources.Num() > 0 || Instances.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Parallel arrays. Sources hold raw pointers so the build reads nothing but this array and the components.
+	TArray<TWeakObjectPtr<UHealthResourceWithUI>> Resources;
+	TArray<FOverheadBarSource> Sources;
+
+	TArray<FOverheadBarStyle> Styles;
+	TArray<FOverheadBarInstance> Instances;
+	TArray<FVector> ScreenPositions;
+	FDelegateHandle PostRenderHandle;
+
+	uint8 InternStyle(const FOverheadBarStyle& style);
+	void DrawInstances(AHUD* hud, UCanvas* canvas);
+};
@@ -0,0 +1,82 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "OverheadBarManager.generated.h"
+
+class UHealthResourceWithUI;
+class UWidgetComponent;
+
+/**
+ * Client-side overhead bars for health resources with OverheadRenderMode set to Pooled.
+ * A fixed pool of widget components is reassigned every frame to the most relevant registered resources: within
+ * ResourceComp.OverheadBars.MaxDistance of the local view, recently rendered, ranked by distance with recently
+ * damaged actors first. Bars that are no longer needed are hidden and returned to the pool, so memory is bounded
+ * by ResourceComp.OverheadBars.PoolSize instead of by actor count. Never created on dedicated servers.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UOverheadBarManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UOverheadBarManager* Get(const UObject* worldContext);
+
+	void Register(UHealthResourceWithUI* resource);
+	void Unregister(UHealthResourceWithUI* resource);
+	int32 GetNumAssigned() const { return NumAssigned; }
+	/*
+	 * ResourceComp.OverheadBars.MaxDistance. Also used by UOverheadBarBatchRenderer.
+	 */
+	static float GetMaxDistance();
+	/*
+	 * ResourceComp.OverheadBars.RecentDamageTime. Also used by UResourceUISignificance.
+	 */
+	static float GetRecentDamageTime();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Registered.Num() > 0 || NumAssigned > 0; }
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FRegisteredBar {
+		TWeakObjectPtr<UHealthResourceWithUI> Resource;
+		TObjectKey<UHealthResourceWithUI> Key;
+		FDelegateHandle DrainHandle;
+		double LastDamageTime = -1.0;
+		// Index into Pool, or INDEX_NONE while the resource has no bar.
+		int32 PoolIndex = INDEX_NONE;
+	};
+
+	// Owns the pooled components. Spawned on first use.
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> PoolOwner;
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UWidgetComponent>> Pool;
+	// Index into Registered for each pooled bar, or INDEX_NONE while it is free.
+	TArray<int32> PoolAssignments;
+
+	TArray<FRegisteredBar> Registered;
+	TMap<TObjectKey<UHealthResourceWithUI>, int32> RegisteredIndices;
+	int32 NumAssigned = 0;
+
+	// Reused every tick.
+	TArray<TPair<float, int32>> Candidates;
+	TBitArray<> Selected;
+
+	/*
+	 * Lower is more relevant. Negative if the resource should not have a bar this frame.
+	 */
+	float ScoreResource(const FRegisteredBar& bar, const FVector& viewLocation, double now, float maxDistanceSquared) const;
+	/*
+	 * Returns a free pooled bar, preferring one that already holds the resource's widget class. Grows the pool up to its size.
+	 */
+	int32 AcquireBar(const UHealthResourceWithUI& resource);
+	void ReleaseBar(int32 registeredIndex);
+	void ConfigureBar(UWidgetComponent& component, UHealthResourceWithUI& resource) const;
+	void RemoveRegisteredAt(int32 index);
+};
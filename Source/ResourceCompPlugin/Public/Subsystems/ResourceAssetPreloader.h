@@ -0,0 +1,40 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ResourceAssetPreloader.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * Loads the soft data assets that resources need on the server, once per world, through the asset manager's
+ * streamable manager. Resources request their assets when they register, so the loads run while the level streams
+ * in, and the handles keep the assets resident until the world ends. Only created for game worlds.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceAssetPreloader : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceAssetPreloader* Get(const UObject* worldContext);
+
+	/*
+	 * Starts loading the asset, unless it was already requested in this world.
+	 */
+	void Request(const FSoftObjectPath& path);
+	/*
+	 * Returns the asset. If its load has not finished, waits for the rest of it, so only the first resource to
+	 * begin play before its preload completed waits.
+	 */
+	UObject* Resolve(const FSoftObjectPath& path);
+	template<typename T>
+	T* Resolve(const TSoftObjectPtr<T>& asset) { return Cast<T>(Resolve(asset.ToSoftObjectPath())); }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+private:
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> Handles;
+};
@@ -0,0 +1,89 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h"
+#include "UObject/ObjectKey.h"
+#include "Data/DamageModificationData.h"
+#include "ResourceCommandSubsystem.generated.h"
+
+class UResourceComponentBase;
+class UHealthResource;
+class UDamageType;
+class AController;
+
+enum class EResourceCommandType : uint8 {
+	Add,
+	Drain,
+	Damage
+};
+
+/**
+ * A deferred Add, Drain or Damage request. Can be built and enqueued from any thread.
+ */
+struct FResourceCommand {
+	TWeakObjectPtr<UResourceComponentBase> Target;
+	EResourceCommandType Type = EResourceCommandType::Drain;
+	float Amount = 0.f;
+	/*
+	 * Orders commands on the same target. Commands with equal keys keep the order they were issued in when one thread
+	 * issued them, since each thread's commands leave the queue in order. Commands for one target issued from several
+	 * threads need distinct keys, e.g. a hit or projectile id, or their order depends on thread timing.
+	 */
+	uint64 SortKey = 0;
+
+	// Damage only. These match the parameters of the damage binders on UHealthResource.
+	TEnumAsByte<EIncomingDamageChannel> DamageChannel = EIncomingDamageChannel::GenericDamage;
+	const UDamageType* DamageType = nullptr;
+	FName BoneName;
+	FVector DamageOrigin = FVector::ZeroVector;
+	FVector HitLocation = FVector::ZeroVector;
+	TWeakObjectPtr<AController> InstigatedBy;
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	// Filled in by the subsystem while committing.
+	// Position of the target in the targets sorted by path name, which groups commands by target in a reproducible order.
+	int32 TargetOrder = 0;
+	float ModifiedAmount = 0.f;
+	bool bModified = false;
+};
+
+/**
+ * Thread-safe command buffer for resource changes.
+ * Any thread may enqueue into the lock-free queue. Once per frame the game thread drains it, evaluates damage
+ * modification for every target in a ParallelFor, and then commits all results in one pass that also broadcasts
+ * the usual delegates. Targets are committed in path name order and each target's commands by SortKey, so the
+ * result is reproducible as long as commands issued for one target from several threads have distinct keys.
+ * Commands are only committed on the authority.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceCommandSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	/*
+	 * Thread-safe.
+	 */
+	void Enqueue(FResourceCommand&& command);
+	void EnqueueAdd(UResourceComponentBase* target, float amount, uint64 sortKey);
+	void EnqueueDrain(UResourceComponentBase* target, float amount, uint64 sortKey);
+	void EnqueueDamage(UHealthResource* target, float damage, uint64 sortKey, EIncomingDamageChannel channel, const UDamageType* damageType,
+		FVector damageOrigin, FName boneName = NAME_None, AActor* damageCauser = nullptr, AController* instigatedBy = nullptr);
+
+	/*
+	 * Commits everything queued so far. Game thread only. Called automatically every frame.
+	 */
+	void Flush();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	TQueue<FResourceCommand, EQueueMode::Mpsc> Queue;
+	// Reused between flushes.
+	TArray<FResourceCommand> Pending;
+	TMap<TObjectKey<UResourceComponentBase>, int32> TargetOrders;
+	TArray<TPair<FString, TObjectKey<UResourceComponentBase>>> TargetPaths;
+};
@@ -0,0 +1,57 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Components/ResourceComponentBase.h"
+#include "ResourceEventSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnResourceBusEvent, UResourceComponentBase* /*resource*/, float /*value*/);
+
+/**
+ * Frame-batched event bus for resources with bBatchEvents set.
+ * Events are queued per component and collapsed, so each event type fires at most once per component per frame
+ * with its latest value. The queue is flushed once per frame: each component's own delegates are broadcast, then
+ * the bus subscribers of that event type. Subscribers are kept per event type, so a listener that only cares about
+ * Empty is never called for regen ticks.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceEventSubsystem* Get(const UObject* worldContext);
+
+	/*
+	 * Subscribes to one event type on every batched resource in this world.
+	 */
+	FDelegateHandle Subscribe(EResourceEventType type, FOnResourceBusEvent::FDelegate&& delegate);
+	void Unsubscribe(EResourceEventType type, FDelegateHandle handle);
+	void UnsubscribeAll(const void* userObject);
+
+	/*
+	 * Queues ResourceCore event flags for the component. Events raised during a flush go out next frame.
+	 */
+	void QueueEvents(UResourceComponentBase* resource, uint32 events, float value);
+	/*
+	 * Dispatches everything queued. Called automatically once per frame.
+	 */
+	void Flush();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FPendingEvents {
+		TWeakObjectPtr<UResourceComponentBase> Resource;
+		uint32 Events = 0;
+		float Values[RET_MAX] = {};
+	};
+
+	FOnResourceBusEvent Subscribers[RET_MAX];
+	TArray<FPendingEvents> Pending;
+	TArray<FPendingEvents> Dispatching;
+	TMap<TObjectKey<UResourceComponentBase>, int32> PendingIndices;
+};
@@ -0,0 +1,102 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ResourceRPCIntake.generated.h"
+
+class UNetConnection;
+class UResourceComponentBase;
+
+/*
+ * Everything clients asked of one resource since the last flush, merged.
+ */
+struct FResourceIntakeRequests {
+	// Requested adds (positive) and drains (negative) in arrival order. Consecutive requests of the same sign are
+	// summed, which clamps the same as applying them one by one.
+	TArray<float, TInlineAllocator<2>> AmountSteps;
+	// The latest requested drain time.
+	float DrainTime = 0.f;
+	bool bHasDrainTime = false;
+	// The latest requested widget settings. Only used by UHealthResourceWithUI.
+	bool bUseOnscreen = false;
+	uint8 OverheadVisibility = 0;
+	bool bHasWidgetSettings = false;
+};
+
+/*
+ * Request counts since the last reset.
+ */
+struct FResourceIntakeCounters {
+	// Requests admitted into a pending batch.
+	int64 Accepted = 0;
+	// Accepted requests folded into a batch that was already pending for the same resource.
+	int64 Merged = 0;
+	// Requests refused because their connection ran out of tokens.
+	int64 Dropped = 0;
+	// Batches applied to resources.
+	int64 Applied = 0;
+};
+
+/**
+ * Server-side intake for the Server RPCs clients send to resource components.
+ * Every request costs its connection one token. A connection's bucket refills at ResourceComp.RPCIntake.Rate tokens
+ * per second up to ResourceComp.RPCIntake.Burst, and requests arriving with the bucket empty are dropped. Accepted
+ * requests are merged per resource and applied once per frame, so however fast a client sends, each resource
+ * changes and broadcasts at most once per run of adds or drains. Requests the server makes to itself, which have no connection,
+ * are merged but never dropped. ResourceComp.RPCIntake.Stats prints the counters.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceRPCIntake : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceRPCIntake* Get(const UObject* worldContext);
+
+	void SubmitAmount(UResourceComponentBase* resource, float amountDelta);
+	void SubmitDrainTime(UResourceComponentBase* resource, float drainTime);
+	void SubmitWidgetSettings(UResourceComponentBase* resource, bool bUseOnscreen, uint8 overheadVisibility);
+
+	/*
+	 * Applies every pending batch. Called automatically every frame.
+	 */
+	void Flush();
+
+	const FResourceIntakeCounters& GetCounters() const { return Counters; }
+	void ResetCounters();
+	/*
+	 * Logs the counters, in total and per connection.
+	 */
+	void LogCounters() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Pending.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FTokenBucket {
+		float Tokens = 0.f;
+		double LastRefillTime = -1.0;
+		FString ConnectionName;
+		FResourceIntakeCounters Counters;
+	};
+	struct FPendingBatch {
+		TWeakObjectPtr<UResourceComponentBase> Resource;
+		FResourceIntakeRequests Requests;
+	};
+
+	TMap<TObjectKey<UNetConnection>, FTokenBucket> Buckets;
+	// In arrival order. PendingIndices maps each resource to its batch.
+	TArray<FPendingBatch> Pending;
+	TMap<TObjectKey<UResourceComponentBase>, int32> PendingIndices;
+	FResourceIntakeCounters Counters;
+
+	/*
+	 * Charges the resource owner's connection for one request. Returns the resource's pending requests to merge
+	 * into, or null if the request is dropped.
+	 */
+	FResourceIntakeRequests* Admit(UResourceComponentBase* resource);
+	bool TryConsumeToken(UNetConnection* connection, FResourceIntakeCounters*& outConnectionCounters);
+};
@@ -0,0 +1,54 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/ResourceComponentBase.h"
+#include "ResourceSimulationLOD.generated.h"
+
+DECLARE_DELEGATE_RetVal_OneParam(EResourceSimulationLOD, FResourceSimulationLODResolver, const UResourceComponentBase* /*resource*/);
+
+/**
+ * Sets the simulation LOD of every resource with bUseSimulationLOD, on the server.
+ * Every ResourceComp.SimLOD.UpdateInterval seconds each resource gets the LOD returned by Resolver, or by default one
+ * from its distance to the nearest player's view: Full within ResourceComp.SimLOD.ReducedDistance, Reduced within
+ * ResourceComp.SimLOD.DormantDistance, and Dormant beyond.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceSimulationLOD : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceSimulationLOD* Get(const UObject* worldContext);
+	/*
+	 * ResourceComp.SimLOD.ReducedRegenInterval. How often resources at Reduced apply their regen.
+	 */
+	static float GetReducedRegenInterval();
+	/*
+	 * The default LOD for a resource this far from the nearest player's view.
+	 */
+	static EResourceSimulationLOD GetLODForDistance(float distance);
+
+	/*
+	 * Replaces the distance based LOD when bound, e.g. with a significance manager's or the replication graph's view of the actor.
+	 */
+	FResourceSimulationLODResolver Resolver;
+
+	void Register(UResourceComponentBase* resource);
+	void Unregister(UResourceComponentBase* resource);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Registered.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	TArray<TWeakObjectPtr<UResourceComponentBase>> Registered;
+	float TimeUntilUpdate = 0.f;
+
+	// Reused every update.
+	TArray<FVector> ViewLocations;
+	TArray<TWeakObjectPtr<UResourceComponentBase>> UpdateList;
+
+	EResourceSimulationLOD GetDefaultLOD(const UResourceComponentBase& resource) const;
+};
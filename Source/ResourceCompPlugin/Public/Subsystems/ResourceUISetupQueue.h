@@ -0,0 +1,39 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ResourceUISetupQueue.generated.h"
+
+class UHealthResourceWithUI;
+
+/**
+ * Spreads the creation of per-actor overhead widgets over several frames, so a spawn wave does not hitch.
+ * Each frame, queued resources are set up nearest to the local view first until ResourceComp.UI.SetupBudgetUs
+ * microseconds have been spent. At least one resource is set up per frame. A budget of 0 or less sets
+ * resources up immediately instead of queueing them. Never created on dedicated servers.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceUISetupQueue : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceUISetupQueue* Get(const UObject* worldContext);
+	/*
+	 * If resources should be queued rather than set up immediately.
+	 */
+	static bool IsEnabled();
+
+	void Enqueue(UHealthResourceWithUI* resource);
+	void Remove(UHealthResourceWithUI* resource);
+	int32 Num() const { return Pending.Num(); }
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Pending.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	TArray<TWeakObjectPtr<UHealthResourceWithUI>> Pending;
+};
@@ -0,0 +1,61 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ResourceUISignificance.generated.h"
+
+class UHealthResourceWithUI;
+
+/**
+ * Lowers the update rate of per-actor overhead widgets that matter little to the local player.
+ * Every ResourceComp.UI.SignificanceInterval seconds, widgets are ranked like pooled bars: recently damaged first, then
+ * by distance to the local view. The first ResourceComp.UI.FullRateBars update every frame, the other visible ones every
+ * ResourceComp.UI.ReducedUpdateInterval seconds. Widgets that are off screen, hidden or out of range are not redrawn
+ * and get no regen updates. Drains are always delivered to UResourceWidgetBase widgets on the next frame.
+ * The budget cvars are meant to be set per platform, e.g. in the device profiles. Never created on dedicated servers.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceUISignificance : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceUISignificance* Get(const UObject* worldContext);
+
+	void Register(UHealthResourceWithUI* resource);
+	void Unregister(UHealthResourceWithUI* resource);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Tracked.Num() > 0; }
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	enum class ETier : uint8 {
+		Full,
+		Reduced,
+		Hidden
+	};
+	struct FTrackedResource {
+		TWeakObjectPtr<UHealthResourceWithUI> Resource;
+		TObjectKey<UHealthResourceWithUI> Key;
+		FDelegateHandle DrainHandle;
+		double LastDamageTime = -1.0;
+		// Full until first ranked, so new widgets start at the default rate.
+		ETier Tier = ETier::Full;
+		float AppliedInterval = 0.f;
+	};
+
+	TArray<FTrackedResource> Tracked;
+	TMap<TObjectKey<UHealthResourceWithUI>, int32> TrackedIndices;
+	float TimeUntilUpdate = 0.f;
+
+	// Reused every update.
+	TArray<TPair<float, int32>> Candidates;
+
+	void ApplyTier(FTrackedResource& tracked, ETier tier, float reducedInterval);
+	void RemoveTrackedAt(int32 index);
+};
@@ -0,0 +1,109 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/ResourceCore.h"
+#include "ResourceWorldStore.generated.h"
+
+class UResourceComponentBase;
+
+/*
+ * Refers to one entry of a UResourceWorldStore. Stays valid while entries around it are added and removed,
+ * and goes stale when its own entry is removed.
+ */
+struct FResourceStoreHandle {
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+	void Reset() { Index = INDEX_NONE; Generation = 0; }
+};
+
+/**
+ * Optional struct-of-arrays storage for resource state, used by components with bUseWorldStore set.
+ * Current and max amounts, regen parameters and drain times live in parallel dense arrays, and the component
+ * becomes a handle into them. Regen for every stored resource runs as one linear pass per frame instead of one
+ * timer per component. Whole-world passes (analytics, save, damage over time) can read the arrays directly.
+ * Entries are only registered on the authority. Removing an entry swaps the last entry into its place.
+ */
+UCLASS()
+class RESOURCECOMPPLUGIN_API UResourceWorldStore : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	static UResourceWorldStore* Get(const UObject* worldContext);
+
+	FResourceStoreHandle Register(UResourceComponentBase* resource, float currentAmount, float maxAmount, const ResourceCore::FRegenParams& params);
+	void Unregister(FResourceStoreHandle& handle);
+	bool IsValidHandle(const FResourceStoreHandle& handle) const { return GetDenseIndex(handle) != INDEX_NONE; }
+
+	// Per-entry operations. These follow ResourceCore and return its event flags.
+
+	uint32 Add(const FResourceStoreHandle& handle, float amount);
+	uint32 Drain(const FResourceStoreHandle& handle, float amount);
+	/*
+	 * Overwrites the amounts and regen parameters. The regen schedule is left alone.
+	 */
+	void SetValues(const FResourceStoreHandle& handle, float currentAmount, float maxAmount, const ResourceCore::FRegenParams& params);
+	/*
+	 * Schedules regen. A negative delay restarts it as after a drain. A positive delay only starts regen
+	 * that is not already scheduled, so parameter changes do not reset a running regen.
+	 */
+	void ScheduleRegen(const FResourceStoreHandle& handle, float initialDelay);
+	/*
+	 * Overwrites the drain time and regen schedule, e.g. with imported state. A negative nextRegenTime unschedules regen.
+	 */
+	void SetSchedule(const FResourceStoreHandle& handle, double timeAtLastDrain, double nextRegenTime, bool bFirstTick);
+	float GetCurrentAmount(const FResourceStoreHandle& handle) const;
+
+	// Batch access. Indices are dense and change when entries are removed.
+
+	int32 Num() const { return CurrentAmounts.Num(); }
+	TConstArrayView<float> GetCurrentAmounts() const { return CurrentAmounts; }
+	TConstArrayView<float> GetMaxAmounts() const { return MaxAmounts; }
+	TConstArrayView<double> GetTimesAtLastDrain() const { return TimesAtLastDrain; }
+	UResourceComponentBase* GetResource(int32 denseIndex) const { return Resources.IsValidIndex(denseIndex) ? Resources[denseIndex].Get() : nullptr; }
+	/*
+	 * Current/Maximum for every entry, in dense order.
+	 */
+	void GetPercents(TArray<float>& outPercents) const;
+	/*
+	 * Applies every regen tick due at or before now and notifies the components. Called automatically every frame.
+	 */
+	void AdvanceRegen(double now);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Dense, parallel arrays.
+	TArray<float> CurrentAmounts;
+	TArray<float> MaxAmounts;
+	TArray<float> RegenAmounts;
+	TArray<float> RegenRates;
+	TArray<float> RegenDelays;
+	TArray<float> AdditionalExhaustedDelays;
+	TArray<double> TimesAtLastDrain;
+	TArray<double> NextRegenTimes;
+	TArray<uint8> bRegenAfterDepletion;
+	TArray<uint8> bFirstRegenTick;
+	TArray<TWeakObjectPtr<UResourceComponentBase>> Resources;
+	TArray<int32> DenseToSparse;
+
+	// Handle indirection.
+	TArray<int32> SparseToDense;
+	TArray<uint32> Generations;
+	TArray<int32> FreeSparse;
+
+	// Reused by AdvanceRegen.
+	TArray<FResourceStoreHandle> DueScratch;
+
+	int32 GetDenseIndex(const FResourceStoreHandle& handle) const;
+	FResourceStoreHandle MakeHandle(int32 denseIndex) const;
+	ResourceCore::FResourceState GatherState(int32 denseIndex) const;
+	ResourceCore::FRegenParams GatherParams(int32 denseIndex) const;
+	void ScatterState(int32 denseIndex, const ResourceCore::FResourceState& state);
+	double GetNow() const;
+};
@@ -0,0 +1,90 @@
+// Copyright LyCH. 2024
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/ResourceComponentBase.h"
+#include "ResourceWidgetBase.generated.h"
+
+/**
+ * Base class for widgets that display a resource. The resource components bind it with Bind Resource when they create
+ * it, with no lookup by name. Instead of polling or binding the resource's delegates, the widget receives at most one
+ * On Resource Updated per frame, carrying the percent, the change since the last update and every event since then.
+ * Updates are further limited by Update Interval, and Get Displayed Percent eases toward the latest percent, so
+ * frequent regen ticks do not redraw the widget every time.
+ */
+UCLASS(Abstract, Blueprintable)
+class RESOURCECOMPPLUGIN_API UResourceWidgetBase : public UUserWidget
+{
+	GENERATED_BODY()
+public:
+	/*
+	 * Displays resource, replacing the previous one. Null unbinds.
+	 */UFUNCTION(BlueprintCallable, Category = "Resource|UI")
+	void BindResource(UResourceComponentBase* resource);
+	/*
+	 * The bound resource.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|UI")
+	UResourceComponentBase* GetResource() const { return Resource.Get(); }
+	/*
+	 * The percent passed to the last On Resource Updated.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|UI")
+	float GetTargetPercent() const { return TargetPercent; }
+	/*
+	 * Eases toward Get Target Percent at Interp Speed. Use this to draw bars.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|UI")
+	float GetDisplayedPercent() const { return DisplayedPercent; }
+	/*
+	 * If the event flags of an update include the event type.
+	 */UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Resource|UI")
+	static bool HasResourceEvent(int32 eventFlags, EResourceEventType type) { return (eventFlags & (1 << type)) != 0; }
+	/*
+	 * Set by UResourceUISignificance. Updates wait at least minInterval, on top of Update Interval. Without bDeliverRegen,
+	 * only drains and empties are delivered, and other changes such as regen wait until it is set again.
+	 * Drains and empties are always delivered on the next frame.
+	 */
+	void SetUpdateThrottle(float minInterval, bool bDeliverRegen);
+
+protected:
+	/*
+	 * The minimum seconds between updates. 0 updates at most once per frame.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|UI", meta = (ClampMin = 0.0))
+	float UpdateInterval = 0.05f;
+	/*
+	 * How fast Get Displayed Percent follows the target percent. 0 snaps.
+	 */UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Resource|UI", meta = (ClampMin = 0.0))
+	float InterpSpeed = 10.f;
+
+	/*
+	 * Called after a resource is bound, or with null after it is unbound.
+	 */UFUNCTION(BlueprintImplementableEvent, Category = "Resource|UI")
+	void OnResourceBound(UResourceComponentBase* resource);
+	/*
+	 * Called at most once per frame after the bound resource changed.
+	 * @param percent The current percent.
+	 * @param delta The change in percent since the last update.
+	 * @param eventFlags Every event since the last update. Test with Has Resource Event.
+	 */UFUNCTION(BlueprintImplementableEvent, Category = "Resource|UI")
+	void OnResourceUpdated(float percent, float delta, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/ResourceCompPlugin.EResourceEventType")) int32 eventFlags);
+
+	virtual void NativeOnResourceBound(UResourceComponentBase* resource);
+	virtual void NativeOnResourceUpdated(float percent, float delta, uint32 eventFlags);
+
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	virtual void NativeDestruct() override;
+
+private:
+	TWeakObjectPtr<UResourceComponentBase> Resource;
+	FDelegateHandle EventHandles[RET_MAX];
+	// Events since the last update, one bit per EResourceEventType.
+	uint32 PendingEvents = 0;
+	float TargetPercent = 0.f;
+	float DisplayedPercent = 0.f;
+	float TimeSinceUpdate = 0.f;
+	float ThrottleInterval = 0.f;
+	bool bThrottleRegen = false;
+
+	void UnbindResource();
+	void FlushUpdate();
+};
@@ -43,10 +43,14 @@ public class ResourceCompPlugin : ModuleRules
 				"Slate",
 				"SlateCore",
 				"UMG",
+				"RenderCore",
 				//"Projects"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// Defines UE_WITH_IRIS and links IrisCore for the net serializers in Net/ResourceNetSerializers.
+		SetupIrisSupport(Target);
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
@@ -0,0 +1,138 @@
+// Copyright LyCH. 2024
+
+// Microbenchmarks for ResourceCore, without the engine. The same workloads as the ResourceComp.Bench.Core console
+// command, plus the cached damage steps and threshold evaluation. Args: [Iterations=10000000]
+
+#include "Core/ResourceCore.h"
+#include "Core/ResourceCorePolicies.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace ResourceCore;
+
+namespace {
+	volatile float Sink = 0.f;
+
+	using FClock = std::chrono::steady_clock;
+
+	double NanosecondsPerOp(FClock::time_point start, int64_t ops) {
+		const double seconds = std::chrono::duration<double>(FClock::now() - start).count();
+		return seconds * 1e9 / static_cast<double>(ops > 0 ? ops : 1);
+	}
+
+	std::vector<FModificationRule> MakeBenchRules() {
+		std::vector<FModificationRule> rules(8);
+		for (int32_t r = 0; r < 8; r++) {
+			rules[r].Type = r % 2 ? EModificationType::Multiply : EModificationType::Add;
+			rules[r].Magnitude = r % 2 ? 0.9f : 1.f;
+			rules[r].Channel = static_cast<EDamageChannel>(r % 4);
+			rules[r].MaximumRange = r == 3 ? 1000.f : 0.f;
+			if (r == 5) {
+				rules[r].Bones = { 1, 2, 3 };
+			}
+		}
+		return rules;
+	}
+}
+
+int main(int argc, char** argv) {
+	const int64_t iterations = argc > 1 ? std::max<int64_t>(1, std::atoll(argv[1])) : 10000000;
+
+	/* Add/Drain */ {
+		FResourceState state;
+		const FRegenParams params;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			Drain(state, 7.f, static_cast<double>(i), params);
+			Add(state, 5.f, static_cast<double>(i), params);
+		}
+		Sink = state.Current;
+		std::printf("Add+Drain                      %8.2f ns/op\n", NanosecondsPerOp(start, iterations * 2));
+	}
+	/* Add/Drain, fixed policies */ {
+		FResourceState state;
+		const FRegenParams params;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			FManaResourceCore::Drain(state, 7.f, static_cast<double>(i), params);
+			FManaResourceCore::Add(state, 5.f, static_cast<double>(i), params);
+		}
+		Sink = state.Current;
+		std::printf("Add+Drain (FManaResourceCore)  %8.2f ns/op\n", NanosecondsPerOp(start, iterations * 2));
+	}
+	/* Regen catch-up */ {
+		FResourceState state;
+		const FRegenParams params;
+		double now = 0.0;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			if (state.NextRegenTime < 0) {
+				Drain(state, 50.f, now, params);
+			}
+			now += 0.1;
+			AdvanceRegen(state, now, params);
+		}
+		Sink = state.Current;
+		std::printf("AdvanceRegen                   %8.2f ns/op\n", NanosecondsPerOp(start, iterations));
+	}
+	/* ModifyDamage */ {
+		const std::vector<FModificationRule> rules = MakeBenchRules();
+		const FDamageTypeOps ops;
+		FDamageQuery query;
+		query.Channel = EDamageChannel::Point;
+		query.Bone = 2;
+		float total = 0.f;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			query.Damage = static_cast<float>(i & 63);
+			query.Distance = static_cast<float>(i & 2047);
+			total += ModifyDamage(rules, query, ops);
+		}
+		Sink = total;
+		std::printf("ModifyDamage (8 rules)         %8.2f ns/op\n", NanosecondsPerOp(start, iterations));
+	}
+	/* Cached damage steps, as below Full simulation LOD */ {
+		std::vector<FModificationRule> rules = MakeBenchRules();
+		rules[3].MaximumRange = 0.f;
+		rules[5].Bones.clear();
+		const FDamageTypeOps ops;
+		std::vector<FDamageStep> steps;
+		FilterRules(rules.data(), static_cast<int32_t>(rules.size()), EDamageChannel::Point, 0, ops, steps);
+		FDamageQuery query;
+		query.Channel = EDamageChannel::Point;
+		float total = 0.f;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			query.Damage = static_cast<float>(i & 63);
+			total += ApplyDamageSteps(steps, query, ops);
+		}
+		Sink = total;
+		std::printf("ApplyDamageSteps (8 rules)     %8.2f ns/op\n", NanosecondsPerOp(start, iterations));
+	}
+	/* Thresholds */ {
+		FThresholdSet set;
+		for (int32_t t = 0; t < 16; t++) {
+			FThreshold threshold;
+			threshold.Value = static_cast<float>(t) * 6.25f;
+			threshold.Hysteresis = 2.f;
+			threshold.Id = t + 1;
+			AddThreshold(set, threshold, 100.f);
+		}
+		std::vector<FThresholdCrossing> crossings;
+		float value = 100.f;
+		const FClock::time_point start = FClock::now();
+		for (int64_t i = 0; i < iterations; i++) {
+			const float newValue = static_cast<float>((i * 37) & 127) * (100.f / 127.f);
+			crossings.clear();
+			EvaluateThresholds(set, value, newValue, crossings);
+			value = newValue;
+		}
+		Sink = value + static_cast<float>(crossings.size());
+		std::printf("EvaluateThresholds (16)        %8.2f ns/op\n", NanosecondsPerOp(start, iterations));
+	}
+	return 0;
+}
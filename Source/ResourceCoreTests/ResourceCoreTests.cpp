@@ -0,0 +1,509 @@
+// Copyright LyCH. 2024
+
+// Unit tests for ResourceCore. The Legacy namespace transcribes the component code ResourceCore replaced
+// (UHealthResource::ModifyDamage, ModificationAcceptsDamageType and the UResourceComponentBase regen timer), with the
+// engine types swapped for the core ones, and the tests check the core against it on randomized inputs.
+
+#include "Core/ResourceCore.h"
+#include "Core/ResourceCorePolicies.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ResourceCore;
+
+namespace {
+	int Failures = 0;
+	int Checks = 0;
+
+	void Check(bool bCondition, const char* expression, const char* file, int line) {
+		Checks++;
+		if (!bCondition) {
+			Failures++;
+			std::printf("%s:%d: check failed: %s\n", file, line, expression);
+		}
+	}
+#define CHECK(expression) Check((expression), #expression, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b) Check(std::fabs((a) - (b)) <= 1e-3f, #a " == " #b, __FILE__, __LINE__)
+
+	// Damage types 1 to 8. Parents[t] is the parent of t, 0 for the root types.
+	const FTypeId Parents[] = { 0, 0, 1, 1, 2, 0, 5, 6, 6 };
+
+	bool IsChildOf(FTypeId child, FTypeId parent) {
+		// Like UClass::IsChildOf, a type is a child of itself.
+		for (FTypeId type = child; type != 0; type = Parents[type]) {
+			if (type == parent) {
+				return true;
+			}
+		}
+		return false;
+	}
+	// Even types implement the damage type modification interface.
+	bool ModifyFromDamageType(const void*, FTypeId damageType, float damage, float& outDamage) {
+		if (damageType % 2 != 0) {
+			return false;
+		}
+		outDamage = damage * 2.f + static_cast<float>(damageType);
+		return true;
+	}
+	FDamageTypeOps MakeOps() {
+		FDamageTypeOps ops;
+		ops.IsChildOf = &IsChildOf;
+		ops.ModifyFromDamageType = &ModifyFromDamageType;
+		return ops;
+	}
+}
+
+namespace Legacy {
+	bool ModificationAcceptsDamageType(const FModificationRule& modification, FTypeId damageType) {
+		if (modification.DamageTypes.size() <= 0
+			|| std::find(modification.DamageTypes.begin(), modification.DamageTypes.end(), damageType) != modification.DamageTypes.end()) {
+			return true;
+		}
+		if (!modification.bIncludeChildTypes) {
+			return false;
+		}
+		for (FTypeId damageClass : modification.DamageTypes) {
+			if (IsChildOf(damageType, damageClass)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	float ModifyDamage(const std::vector<FModificationRule>& rules, float damageReceived, EDamageChannel damageChannel, FTypeId damageType, FNameId boneName, float distance) {
+		float modifiedDamage = damageReceived;
+		for (const FModificationRule& modification : rules) {
+			const bool bWhiteListedDamageType = ModificationAcceptsDamageType(modification, damageType);
+			const bool bCorrectBone = damageChannel != EDamageChannel::Point || modification.Bones.empty()
+				|| std::find(modification.Bones.begin(), modification.Bones.end(), boneName) != modification.Bones.end();
+			const bool bWithinRange = (modification.MinimumRange <= 0 || distance >= modification.MinimumRange)
+				&& (modification.MaximumRange <= 0 || distance <= modification.MaximumRange);
+			const bool bCorrectDamageChannel = damageChannel == modification.Channel || modification.Channel == EDamageChannel::All;
+			if (bWhiteListedDamageType && bWithinRange && bCorrectBone && bCorrectDamageChannel) {
+				if (modification.Type == EModificationType::Override) {
+					return modification.Magnitude;
+				}
+				if (modification.Type == EModificationType::FromDamageType) {
+					float typeDamage = 0.f;
+					if (ModifyFromDamageType(nullptr, damageType, damageReceived, typeDamage)) {
+						modifiedDamage = typeDamage;
+					}
+				}
+				if (modification.Type == EModificationType::Add) {
+					modifiedDamage = modifiedDamage + modification.Magnitude;
+				}
+				if (modification.Type == EModificationType::Multiply) {
+					modifiedDamage = modifiedDamage * modification.Magnitude;
+				}
+			}
+		}
+		return modifiedDamage;
+	}
+
+	/*
+	 * UResourceComponentBase's Add, Drain and looping regen timer. The timer fires at NextTick and then every
+	 * interval, once per elapsed interval, as FTimerManager does for a looping timer.
+	 */
+	struct FResource {
+		float CurrentAmount = 100.f;
+		float MaxAmount = 100.f;
+		FRegenParams Params;
+		bool bDrainDisabled = false;
+		double NextTick = -1.0;
+
+		float GetRegenDelay() const {
+			return CurrentAmount <= 0 ? Params.bRegenAfterDepletion ? Params.Delay + Params.AdditionalExhaustedDelay : -1 : Params.Delay;
+		}
+		bool ShouldRegen() const {
+			return !(Params.Amount <= 0 || Params.Rate <= 0 || GetRegenDelay() < 0);
+		}
+		void SetRegenTimer(double now) {
+			NextTick = -1.0;
+			if (!ShouldRegen()) {
+				return;
+			}
+			NextTick = now + GetRegenDelay();
+		}
+		void AddResource(float addAmount, double now) {
+			if (addAmount < 0) {
+				DrainResource(-addAmount, now);
+				return;
+			}
+			if (CurrentAmount >= MaxAmount) {
+				return;
+			}
+			CurrentAmount = std::min(MaxAmount, CurrentAmount + addAmount);
+		}
+		void DrainResource(float drainAmount, double now) {
+			if (drainAmount < 0) {
+				AddResource(-drainAmount, now);
+				return;
+			}
+			if (bDrainDisabled) {
+				return;
+			}
+			CurrentAmount = std::max(0.f, CurrentAmount - drainAmount);
+			SetRegenTimer(now);
+		}
+		void AdvanceTimer(double now) {
+			while (NextTick >= 0 && NextTick <= now) {
+				const double tickTime = NextTick;
+				NextTick += 1.0 / Params.Rate;
+				// The regen tick: AddResource, which stops the timer once full.
+				if (CurrentAmount >= MaxAmount) {
+					continue;
+				}
+				AddResource(Params.Amount, tickTime);
+				if (CurrentAmount >= MaxAmount) {
+					NextTick = -1.0;
+				}
+			}
+		}
+	};
+}
+
+namespace {
+	float Quarter(std::mt19937& random, int maxQuarters) {
+		return static_cast<float>(std::uniform_int_distribution<int>(0, maxQuarters)(random)) * 0.25f;
+	}
+
+	FModificationRule MakeRandomRule(std::mt19937& random) {
+		std::uniform_int_distribution<int> coin(0, 1);
+		std::uniform_int_distribution<int> typeDist(1, 8);
+		FModificationRule rule;
+		rule.Channel = static_cast<EDamageChannel>(std::uniform_int_distribution<int>(0, 3)(random));
+		rule.Type = static_cast<EModificationType>(std::uniform_int_distribution<int>(0, 3)(random));
+		rule.Magnitude = Quarter(random, 16);
+		if (coin(random)) {
+			rule.MinimumRange = Quarter(random, 2000);
+		}
+		if (coin(random)) {
+			rule.MaximumRange = rule.MinimumRange + Quarter(random, 2000);
+		}
+		if (coin(random)) {
+			rule.Bones = { static_cast<FNameId>(typeDist(random)), static_cast<FNameId>(typeDist(random)) };
+		}
+		const int numTypes = std::uniform_int_distribution<int>(0, 2)(random);
+		for (int i = 0; i < numTypes; i++) {
+			rule.DamageTypes.push_back(static_cast<FTypeId>(typeDist(random)));
+		}
+		rule.bIncludeChildTypes = coin(random) != 0;
+		return rule;
+	}
+
+	void TestModifyDamageMatchesComponent() {
+		std::mt19937 random(1234);
+		const FDamageTypeOps ops = MakeOps();
+		std::vector<FDamageStep> steps;
+		for (int iteration = 0; iteration < 20000; iteration++) {
+			std::vector<FModificationRule> rules;
+			const int numRules = std::uniform_int_distribution<int>(0, 8)(random);
+			for (int r = 0; r < numRules; r++) {
+				rules.push_back(MakeRandomRule(random));
+			}
+			FDamageQuery query;
+			query.Damage = Quarter(random, 400);
+			query.Channel = static_cast<EDamageChannel>(std::uniform_int_distribution<int>(1, 3)(random));
+			query.DamageType = static_cast<FTypeId>(std::uniform_int_distribution<int>(1, 8)(random));
+			query.Bone = static_cast<FNameId>(std::uniform_int_distribution<int>(1, 8)(random));
+			query.Distance = Quarter(random, 4000);
+
+			const float expected = Legacy::ModifyDamage(rules, query.Damage, query.Channel, query.DamageType, query.Bone, query.Distance);
+			CHECK_NEAR(ModifyDamage(rules, query, ops), expected);
+			for (const FModificationRule& rule : rules) {
+				CHECK(AcceptsDamageType(rule, query.DamageType, ops) == Legacy::ModificationAcceptsDamageType(rule, query.DamageType));
+			}
+			// The cached steps used below Full simulation LOD give the same result whenever they can be used.
+			if (FilterRules(rules.data(), static_cast<int32_t>(rules.size()), query.Channel, query.DamageType, ops, steps)) {
+				CHECK_NEAR(ApplyDamageSteps(steps, query, ops), expected);
+			}
+		}
+	}
+
+	void TestModifyDamageOrder() {
+		const FDamageTypeOps ops = MakeOps();
+		std::vector<FModificationRule> rules(3);
+		rules[0].Type = EModificationType::Add;
+		rules[0].Magnitude = 10.f;
+		rules[1].Type = EModificationType::Multiply;
+		rules[1].Magnitude = 2.f;
+		rules[2].Type = EModificationType::Override;
+		rules[2].Magnitude = 1.f;
+		rules[2].Channel = EDamageChannel::Radial;
+		FDamageQuery query;
+		query.Damage = 5.f;
+		query.DamageType = 1;
+		query.Channel = EDamageChannel::Point;
+		// Rules apply in array order.
+		CHECK_NEAR(ModifyDamage(rules, query, ops), 30.f);
+		// Override returns its magnitude, ignoring the rules before it.
+		query.Channel = EDamageChannel::Radial;
+		CHECK_NEAR(ModifyDamage(rules, query, ops), 1.f);
+		// FromDamageType sees the unmodified damage, as the component did.
+		rules[1].Type = EModificationType::FromDamageType;
+		query.Channel = EDamageChannel::Generic;
+		query.DamageType = 2;
+		CHECK_NEAR(ModifyDamage(rules, query, ops), 12.f);
+	}
+
+	void TestRegenCatchUpMatchesTimer() {
+		std::mt19937 random(42);
+		const float rates[] = { 1.f, 2.f, 4.f, 8.f };
+		for (int iteration = 0; iteration < 2000; iteration++) {
+			FRegenParams params;
+			params.Amount = Quarter(random, 40);
+			params.Rate = rates[std::uniform_int_distribution<int>(0, 3)(random)];
+			params.Delay = Quarter(random, 12);
+			params.AdditionalExhaustedDelay = Quarter(random, 8);
+			params.bRegenAfterDepletion = std::uniform_int_distribution<int>(0, 1)(random) != 0;
+
+			Legacy::FResource legacy;
+			legacy.Params = params;
+			legacy.MaxAmount = 25.f + Quarter(random, 400);
+			legacy.CurrentAmount = legacy.MaxAmount;
+			FResourceState state;
+			state.Max = legacy.MaxAmount;
+			state.Current = legacy.CurrentAmount;
+
+			// Every time, delay and interval is a multiple of 1/64 s, so both sides compute the same tick times exactly.
+			double now = 0.0;
+			for (int step = 0; step < 40; step++) {
+				now += std::uniform_int_distribution<int>(0, 64)(random) / 16.0 + 1.0 / 64.0;
+				legacy.AdvanceTimer(now);
+				AdvanceRegen(state, now, params);
+				CHECK_NEAR(state.Current, legacy.CurrentAmount);
+
+				const float amount = Quarter(random, 200);
+				switch (std::uniform_int_distribution<int>(0, 4)(random)) {
+				case 0:
+				case 1:
+					legacy.DrainResource(amount, now);
+					Drain(state, amount, now, params);
+					break;
+				case 2:
+					legacy.AddResource(amount, now);
+					Add(state, amount, now, params);
+					break;
+				case 3:
+					legacy.bDrainDisabled = !legacy.bDrainDisabled;
+					state.bDrainDisabled = legacy.bDrainDisabled;
+					break;
+				default:
+					break;
+				}
+				CHECK_NEAR(state.Current, legacy.CurrentAmount);
+			}
+			// A long catch-up in one call.
+			now += 1000.0;
+			legacy.AdvanceTimer(now);
+			AdvanceRegen(state, now, params);
+			CHECK_NEAR(state.Current, legacy.CurrentAmount);
+		}
+	}
+
+	void TestRegenEvents() {
+		FRegenParams params;
+		params.Amount = 10.f;
+		params.Rate = 2.f;
+		params.Delay = 1.f;
+		FResourceState state;
+		uint32_t events = Drain(state, 25.f, 0.0, params);
+		CHECK((events & (Event_Changed | Event_Drained)) == (Event_Changed | Event_Drained));
+		CHECK(state.NextRegenTime == 1.0);
+		CHECK(AdvanceRegen(state, 0.5, params) == Event_None);
+		// Ticks at 1.0 and 1.5.
+		int64_t ticks = 0;
+		events = AdvanceRegen(state, 1.6, params, &ticks);
+		CHECK(ticks == 2);
+		CHECK((events & Event_RegenStart) != 0);
+		CHECK((events & Event_RegenEnd) == 0);
+		CHECK_NEAR(state.Current, 95.f);
+		// The tick at 2.0 fills it.
+		events = AdvanceRegen(state, 2.0, params, &ticks);
+		CHECK(ticks == 1);
+		CHECK((events & (Event_RegenEnd | Event_Filled)) == (Event_RegenEnd | Event_Filled));
+		CHECK((events & Event_RegenStart) == 0);
+		CHECK(state.NextRegenTime < 0);
+		// Depleted health without regen after depletion stays down.
+		Drain(state, 200.f, 3.0, params);
+		CHECK(state.NextRegenTime < 0);
+		CHECK(AdvanceRegen(state, 100.0, params) == Event_None);
+		CHECK_NEAR(state.Current, 0.f);
+	}
+
+	void TestPolicies() {
+		const FRegenParams params;
+		FResourceState state;
+		// Stamina never reports Drained or Added, and always recovers from empty.
+		uint32_t events = FStaminaResourceCore::Drain(state, 100.f, 0.0, params);
+		CHECK(events == (Event_Changed | Event_Emptied));
+		CHECK(state.NextRegenTime >= 0);
+		// Stamina ignores the drain lockout; the default core does not.
+		state.bDrainDisabled = true;
+		state.Current = 50.f;
+		CHECK(FStaminaResourceCore::Drain(state, 10.f, 0.0, params) != Event_None);
+		CHECK(FDefaultResourceCore::Drain(state, 10.f, 0.0, params) == Event_None);
+		CHECK_NEAR(state.Current, 40.f);
+		// Overfill keeps adding past Max, and fires Filled once when Max is reached.
+		using FOverfillCore = TResourceCore<Policy::FAllowOverfill, Policy::FDepletionFromParams, Policy::FLockoutFromState>;
+		FResourceState shield;
+		shield.Current = 90.f;
+		CHECK((FOverfillCore::Add(shield, 20.f, 0.0, params) & Event_Filled) != 0);
+		CHECK((FOverfillCore::Add(shield, 20.f, 0.0, params) & Event_Filled) == 0);
+		CHECK_NEAR(shield.Current, 130.f);
+	}
+
+	void TestAggregateStat() {
+		const FStatModifier modifiers[] = {
+			{ EStatOperation::Flat, 10.f },
+			{ EStatOperation::PercentAdd, 0.5f },
+			{ EStatOperation::Multiply, 2.f },
+			{ EStatOperation::PercentAdd, 0.25f }
+		};
+		CHECK_NEAR(AggregateStat(100.f, modifiers, 4), (100.f + 10.f) * 1.75f * 2.f);
+		const FStatModifier overridden[] = {
+			{ EStatOperation::Override, 5.f },
+			{ EStatOperation::Flat, 10.f },
+			{ EStatOperation::Override, 7.f }
+		};
+		// The last override wins.
+		CHECK_NEAR(AggregateStat(100.f, overridden, 3), 7.f);
+		CHECK_NEAR(AggregateStat(100.f, nullptr, 0), 100.f);
+	}
+
+	/*
+	 * The threshold contract evaluated on every threshold, without the sorted range search EvaluateThresholds uses.
+	 */
+	void ReferenceEvaluateThresholds(std::vector<FThreshold>& thresholds, float oldValue, float newValue, std::vector<FThresholdCrossing>& outCrossings) {
+		if (oldValue == newValue) {
+			return;
+		}
+		const bool bRising = newValue > oldValue;
+		const auto visit = [&](FThreshold& t) {
+			if (bRising) {
+				if (newValue >= t.Value + t.Hysteresis) {
+					t.bFallingArmed = true;
+				}
+				if (oldValue < t.Value && newValue >= t.Value && t.bRisingArmed) {
+					t.bRisingArmed = false;
+					if (t.Direction != EThresholdDirection::Falling) {
+						outCrossings.push_back({ t.Id, true });
+					}
+				}
+			}
+			else {
+				if (newValue <= t.Value - t.Hysteresis) {
+					t.bRisingArmed = true;
+				}
+				if (oldValue > t.Value && newValue <= t.Value && t.bFallingArmed) {
+					t.bFallingArmed = false;
+					if (t.Direction != EThresholdDirection::Rising) {
+						outCrossings.push_back({ t.Id, false });
+					}
+				}
+			}
+		};
+		if (bRising) {
+			std::for_each(thresholds.begin(), thresholds.end(), visit);
+		}
+		else {
+			std::for_each(thresholds.rbegin(), thresholds.rend(), visit);
+		}
+	}
+
+	void TestThresholdHysteresis() {
+		FThresholdSet set;
+		FThreshold lowHealth;
+		lowHealth.Value = 25.f;
+		lowHealth.Hysteresis = 5.f;
+		lowHealth.Id = 1;
+		AddThreshold(set, lowHealth, 100.f);
+		std::vector<FThresholdCrossing> crossings;
+
+		EvaluateThresholds(set, 100.f, 24.f, crossings);
+		CHECK(crossings.size() == 1 && crossings[0].Id == 1 && !crossings[0].bRising);
+		// Hovering around the threshold does not fire again until the value leaves the hysteresis band.
+		crossings.clear();
+		EvaluateThresholds(set, 24.f, 26.f, crossings);
+		EvaluateThresholds(set, 26.f, 23.f, crossings);
+		EvaluateThresholds(set, 23.f, 29.f, crossings);
+		EvaluateThresholds(set, 29.f, 22.f, crossings);
+		CHECK(crossings.empty());
+		// Rising through Value + Hysteresis re-arms falling; rising was armed by dropping to Value - Hysteresis.
+		EvaluateThresholds(set, 22.f, 19.f, crossings);
+		CHECK(crossings.empty());
+		EvaluateThresholds(set, 19.f, 30.f, crossings);
+		CHECK(crossings.size() == 1 && crossings[0].bRising);
+		crossings.clear();
+		EvaluateThresholds(set, 30.f, 25.f, crossings);
+		CHECK(crossings.size() == 1 && !crossings[0].bRising);
+		CHECK(RemoveThreshold(set, 1));
+		CHECK(!RemoveThreshold(set, 1));
+	}
+
+	void TestThresholdsMatchReference() {
+		std::mt19937 random(7);
+		for (int iteration = 0; iteration < 2000; iteration++) {
+			FThresholdSet set;
+			float value = Quarter(random, 400);
+			const int numThresholds = std::uniform_int_distribution<int>(1, 12)(random);
+			for (int i = 0; i < numThresholds; i++) {
+				FThreshold threshold;
+				threshold.Value = Quarter(random, 400);
+				threshold.Hysteresis = Quarter(random, 40);
+				threshold.Direction = static_cast<EThresholdDirection>(std::uniform_int_distribution<int>(1, 3)(random));
+				threshold.Id = i + 1;
+				AddThreshold(set, threshold, value);
+			}
+			std::vector<FThreshold> reference = set.Thresholds;
+			std::vector<FThresholdCrossing> crossings;
+			std::vector<FThresholdCrossing> expected;
+			for (int step = 0; step < 50; step++) {
+				const float newValue = Quarter(random, 400);
+				crossings.clear();
+				expected.clear();
+				EvaluateThresholds(set, value, newValue, crossings);
+				ReferenceEvaluateThresholds(reference, value, newValue, expected);
+				CHECK(crossings.size() == expected.size());
+				for (size_t i = 0; i < std::min(crossings.size(), expected.size()); i++) {
+					CHECK(crossings[i].Id == expected[i].Id && crossings[i].bRising == expected[i].bRising);
+				}
+				for (size_t i = 0; i < reference.size(); i++) {
+					CHECK(set.Thresholds[i].bFallingArmed == reference[i].bFallingArmed && set.Thresholds[i].bRisingArmed == reference[i].bRisingArmed);
+				}
+				value = newValue;
+			}
+		}
+	}
+
+	void TestAmounts() {
+		CHECK_NEAR(ApplyAdd(90.f, 20.f, 100.f).NewValue, 100.f);
+		CHECK_NEAR(ApplyDrain(10.f, 20.f).NewValue, 0.f);
+		CHECK_NEAR(GetPercent(25.f, 100.f), 0.25f);
+		CHECK_NEAR(GetPercent(25.f, 0.f), 0.f);
+		// Matches the component's broadcast rules: no events without a change.
+		CHECK(GetChangeEvents({ 50.f, 50.f }, 100.f) == Event_None);
+		CHECK(GetChangeEvents({ 50.f, 0.f }, 100.f) == (Event_Changed | Event_Drained | Event_Emptied));
+		CHECK(GetChangeEvents({ 50.f, 100.f }, 100.f) == (Event_Changed | Event_Added | Event_Filled));
+		FResourceState state;
+		// Adding to a full resource does nothing.
+		CHECK(Add(state, 10.f, 0.0, FRegenParams()) == Event_None);
+	}
+}
+
+int main() {
+	TestAmounts();
+	TestModifyDamageMatchesComponent();
+	TestModifyDamageOrder();
+	TestRegenCatchUpMatchesTimer();
+	TestRegenEvents();
+	TestPolicies();
+	TestAggregateStat();
+	TestThresholdHysteresis();
+	TestThresholdsMatchReference();
+	std::printf("ResourceCoreTests: %d checks, %d failed\n", Checks, Failures);
+	return Failures == 0 ? 0 : 1;
+}